@@ -180,6 +180,66 @@ void UNeutronActorTools::PlayCameraShake(
 	PC->ClientStartCameraShake(Shake, Alpha * Scale);
 }
 
+/*----------------------------------------------------
+    Adaptive network update policy
+----------------------------------------------------*/
+
+void FNeutronNetUpdatePolicy::Initialize(AActor* Actor)
+{
+	Actor->NetUpdateFrequency    = MaxNetUpdateFrequency;
+	Actor->MinNetUpdateFrequency = MinNetUpdateFrequency;
+	Actor->bOnlyRelevantToOwner  = OnlyRelevantToOwner;
+
+	if (RelevancyDistance > 0)
+	{
+		Actor->NetCullDistanceSquared = FMath::Square(RelevancyDistance);
+	}
+
+	TimeSinceChange = 0;
+}
+
+void FNeutronNetUpdatePolicy::MarkDirty(AActor* Actor)
+{
+	if (Actor->HasAuthority())
+	{
+		TimeSinceChange           = 0;
+		Actor->NetUpdateFrequency = MaxNetUpdateFrequency;
+
+		// Dormancy we put the actor in is lifted until it goes idle again, other dormancy is only flushed
+		if (UseDormancy && Actor->NetDormancy > DORM_Awake)
+		{
+			Actor->SetNetDormancy(DORM_Awake);
+			Actor->ForceNetUpdate();
+		}
+		else if (Actor->NetDormancy > DORM_Awake)
+		{
+			Actor->FlushNetDormancy();
+		}
+		else
+		{
+			Actor->ForceNetUpdate();
+		}
+	}
+}
+
+void FNeutronNetUpdatePolicy::Update(AActor* Actor, float DeltaTime)
+{
+	if (Actor->HasAuthority() && TimeSinceChange <= IdleDelay)
+	{
+		TimeSinceChange += DeltaTime;
+
+		if (TimeSinceChange > IdleDelay)
+		{
+			Actor->NetUpdateFrequency = MinNetUpdateFrequency;
+
+			if (UseDormancy)
+			{
+				Actor->SetNetDormancy(DORM_DormantAll);
+			}
+		}
+	}
+}
+
 /*----------------------------------------------------
     Location interpolator
 ----------------------------------------------------*/
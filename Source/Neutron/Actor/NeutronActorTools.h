@@ -154,6 +154,70 @@ public:
 	float Brake2;
 };
 
+/*----------------------------------------------------
+    Adaptive network update policy
+----------------------------------------------------*/
+
+/** Replication settings for an actor : relevancy, update rates that drop when idle, optional dormancy */
+USTRUCT()
+struct NEUTRON_API FNeutronNetUpdatePolicy
+{
+	GENERATED_BODY()
+
+public:
+
+	FNeutronNetUpdatePolicy()
+		: MinNetUpdateFrequency(1.0f)
+		, MaxNetUpdateFrequency(10.0f)
+		, IdleDelay(2.0f)
+		, RelevancyDistance(0.0f)
+		, OnlyRelevantToOwner(false)
+		, UseDormancy(false)
+		, TimeSinceChange(0)
+	{}
+
+public:
+
+	/** Apply the relevancy and update settings to an actor */
+	void Initialize(class AActor* Actor);
+
+	/** Signal a replicated state change on the server, restoring the full update rate and waking the actor */
+	void MarkDirty(class AActor* Actor);
+
+	/** Drop the update rate of idle actors on the server */
+	void Update(class AActor* Actor, float DeltaTime);
+
+public:
+
+	// Update rate in Hz when the actor is idle
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float MinNetUpdateFrequency;
+
+	// Update rate in Hz after a change
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float MaxNetUpdateFrequency;
+
+	// Time in seconds without changes after which the actor is considered idle
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float IdleDelay;
+
+	// Distance in units beyond which the actor stops replicating, 0 to use the engine default
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float RelevancyDistance;
+
+	// Replicate only to the owning connection
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool OnlyRelevantToOwner;
+
+	// Go dormant when idle, stopping replication until the next change
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool UseDormancy;
+
+private:
+
+	float TimeSinceChange;
+};
+
 /*----------------------------------------------------
     Time-based moving average structure
 ----------------------------------------------------*/
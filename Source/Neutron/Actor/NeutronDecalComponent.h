@@ -21,9 +21,7 @@ class NEUTRON_API UNeutronDecalComponent
 public:
 
 	UNeutronDecalComponent()
-	{
-		PrimaryComponentTick.bCanEverTick = true;
-	}
+	{}
 
 	/*----------------------------------------------------
 	    Inherited
@@ -36,15 +34,6 @@ public:
 		FNeutronMeshInterfaceBehavior::SetupMaterial(this, GetMaterial(0));
 	}
 
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override
-	{
-		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-		FNeutronMeshInterfaceBehavior::TickMaterial(DeltaTime);
-
-		SetVisibility(CurrentMaterializationTime > 0);
-	}
-
 	virtual void SetMaterial(int32 ElementIndex, UMaterialInterface* InMaterial) override
 	{
 		FNeutronMeshInterfaceBehavior::SetupMaterial(this, InMaterial);
@@ -85,4 +74,9 @@ public:
 	{
 		FNeutronMeshInterfaceBehavior::RequestParameter(Name, Value, Immediate);
 	}
+
+	virtual void OnMaterializationUpdated() override
+	{
+		SetVisibility(CurrentMaterializationTime > 0);
+	}
 };
@@ -0,0 +1,89 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronMaterializationSubsystem.h"
+#include "NeutronMeshInterface.h"
+
+#include "Neutron/Neutron.h"
+
+#include "Components/ActorComponent.h"
+
+// Stats
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Materializing components"), STAT_NeutronMaterializationAwake, STATGROUP_Tickables);
+
+/*----------------------------------------------------
+    Constructor
+----------------------------------------------------*/
+
+UNeutronMaterializationSubsystem::UNeutronMaterializationSubsystem() : Super()
+{}
+
+/*----------------------------------------------------
+    Inherited
+----------------------------------------------------*/
+
+void UNeutronMaterializationSubsystem::Deinitialize()
+{
+	for (FNeutronMaterializationEntry& Entry : AwakeEntries)
+	{
+		if (Entry.Component.IsValid())
+		{
+			Entry.Behavior->MaterialAwake = false;
+		}
+	}
+
+	AwakeEntries.Empty();
+
+	Super::Deinitialize();
+}
+
+/*----------------------------------------------------
+    Interface
+----------------------------------------------------*/
+
+void UNeutronMaterializationSubsystem::Wake(UActorComponent* Component, FNeutronMeshInterfaceBehavior* Behavior)
+{
+	NCHECK(Component);
+	NCHECK(Behavior);
+
+	if (!Behavior->MaterialAwake)
+	{
+		INeutronMeshInterface* Interface = Cast<INeutronMeshInterface>(Component);
+		NCHECK(Interface);
+
+		AwakeEntries.Add(FNeutronMaterializationEntry(Component, Interface, Behavior));
+		Behavior->MaterialAwake = true;
+	}
+}
+
+/*----------------------------------------------------
+    Tick
+----------------------------------------------------*/
+
+void UNeutronMaterializationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	for (int32 Index = AwakeEntries.Num() - 1; Index >= 0; Index--)
+	{
+		// Destroyed components simply leave the list
+		if (!AwakeEntries[Index].Component.IsValid())
+		{
+			AwakeEntries.RemoveAtSwap(Index);
+			continue;
+		}
+
+		// Updates can wake other components, growing the list, so don't hold on to the entry
+		FNeutronMeshInterfaceBehavior* Behavior = AwakeEntries[Index].Behavior;
+		Behavior->TickMaterial(DeltaTime);
+		AwakeEntries[Index].Interface->OnMaterializationUpdated();
+
+		// Components go to sleep once the final state has been applied, entries woken meanwhile were added after this one
+		if (!Behavior->IsMaterialAnimating())
+		{
+			Behavior->MaterialAwake = false;
+			AwakeEntries.RemoveAtSwap(Index);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_NeutronMaterializationAwake, AwakeEntries.Num());
+}
@@ -0,0 +1,70 @@
+// Neutron - Gwennaël Arbona
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "NeutronMaterializationSubsystem.generated.h"
+
+/** Mesh component with an ongoing material animation */
+struct FNeutronMaterializationEntry
+{
+	FNeutronMaterializationEntry(
+		class UActorComponent* NewComponent, class INeutronMeshInterface* NewInterface, struct FNeutronMeshInterfaceBehavior* NewBehavior)
+		: Component(NewComponent), Interface(NewInterface), Behavior(NewBehavior)
+	{}
+
+	TWeakObjectPtr<class UActorComponent> Component;
+	class INeutronMeshInterface*          Interface;
+	struct FNeutronMeshInterfaceBehavior* Behavior;
+};
+
+/** Batched material updates for mesh interface components, only ticking those that are animating */
+UCLASS(ClassGroup = (Neutron))
+class NEUTRON_API UNeutronMaterializationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UNeutronMaterializationSubsystem();
+
+	/*----------------------------------------------------
+	    Inherited
+	----------------------------------------------------*/
+
+	virtual void Deinitialize() override;
+
+	/*----------------------------------------------------
+	    Interface
+	----------------------------------------------------*/
+
+	/** Start updating a component until its material animations are complete */
+	void Wake(class UActorComponent* Component, struct FNeutronMeshInterfaceBehavior* Behavior);
+
+	/** Get the number of components being updated */
+	int32 GetAwakeCount() const
+	{
+		return AwakeEntries.Num();
+	}
+
+	/*----------------------------------------------------
+	    Tick
+	----------------------------------------------------*/
+
+	virtual void    Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UNeutronMaterializationSubsystem, STATGROUP_Tickables);
+	}
+
+	/*----------------------------------------------------
+	    Data
+	----------------------------------------------------*/
+
+protected:
+
+	// Components being updated
+	TArray<FNeutronMaterializationEntry> AwakeEntries;
+};
@@ -1,18 +1,24 @@
 // Neutron - Gwennaël Arbona
 
 #include "NeutronMeshInterface.h"
+#include "NeutronMaterializationSubsystem.h"
 #include "Neutron/UI/NeutronUI.h"
 
 #include "Components/PrimitiveComponent.h"
 #include "Components/DecalComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "Engine/World.h"
 
 /*----------------------------------------------------
     Constructor
 ----------------------------------------------------*/
 
 FNeutronMeshInterfaceBehavior::FNeutronMeshInterfaceBehavior()
-	: ComponentMaterial(nullptr), CurrentMaterializationState(true), CurrentMaterializationTime(0)
+	: ComponentMaterial(nullptr)
+	, MaterialOwner(nullptr)
+	, MaterialAwake(false)
+	, CurrentMaterializationState(true)
+	, CurrentMaterializationTime(0)
 {
 	MaterializationDuration = 0.75f;
 	ParameterFadeDuration   = 0.5f;
@@ -26,11 +32,28 @@ void FNeutronMeshInterfaceBehavior::SetupMaterial(UPrimitiveComponent* Mesh, UMa
 {
 	ComponentMaterial = UMaterialInstanceDynamic::Create(Material, Mesh);
 	Mesh->SetMaterial(0, ComponentMaterial);
+
+	MaterialOwner = Mesh;
+	WakeMaterial();
+}
+
+void FNeutronMeshInterfaceBehavior::SetMaterialOwner(UPrimitiveComponent* Mesh)
+{
+	if (ComponentMaterial == nullptr)
+	{
+		ComponentMaterial = Cast<UMaterialInstanceDynamic>(Mesh->GetMaterial(0));
+	}
+
+	MaterialOwner = Mesh;
+	WakeMaterial();
 }
 
 void FNeutronMeshInterfaceBehavior::SetupMaterial(UDecalComponent* Decal, UMaterialInterface* Material)
 {
 	ComponentMaterial = UMaterialInstanceDynamic::Create(Material, Decal);
+
+	MaterialOwner = Decal;
+	WakeMaterial();
 }
 
 void FNeutronMeshInterfaceBehavior::TickMaterial(float DeltaTime)
@@ -82,6 +105,18 @@ void FNeutronMeshInterfaceBehavior::TickMaterial(float DeltaTime)
 	CurrentRequests = OngoingRequests;
 }
 
+bool FNeutronMeshInterfaceBehavior::IsMaterialAnimating() const
+{
+	if (CurrentMaterializationState)
+	{
+		return CurrentMaterializationTime < MaterializationDuration || CurrentRequests.Num() > 0;
+	}
+	else
+	{
+		return CurrentMaterializationTime > 0 || CurrentRequests.Num() > 0;
+	}
+}
+
 void FNeutronMeshInterfaceBehavior::Materialize(bool Force)
 {
 	CurrentMaterializationState = true;
@@ -90,6 +125,8 @@ void FNeutronMeshInterfaceBehavior::Materialize(bool Force)
 	{
 		CurrentMaterializationTime = MaterializationDuration;
 	}
+
+	WakeMaterial();
 }
 
 void FNeutronMeshInterfaceBehavior::Dematerialize(bool Force)
@@ -100,6 +137,8 @@ void FNeutronMeshInterfaceBehavior::Dematerialize(bool Force)
 	{
 		CurrentMaterializationTime = 0;
 	}
+
+	WakeMaterial();
 }
 
 float FNeutronMeshInterfaceBehavior::GetMaterializationAlpha() const
@@ -136,6 +175,7 @@ void FNeutronMeshInterfaceBehavior::RequestParameter(FName Name, float Value, bo
 		//	PreviousValue);
 
 		CurrentRequests.Add(Request);
+		WakeMaterial();
 	}
 }
 
@@ -174,6 +214,20 @@ void FNeutronMeshInterfaceBehavior::RequestParameter(FName Name, FLinearColor Va
 		//	Value.R, Value.G, Value.B, Value.A, *Name.ToString(), PreviousValue.R, PreviousValue.G, PreviousValue.B, PreviousValue.A);
 
 		CurrentRequests.Add(Request);
+		WakeMaterial();
+	}
+}
+
+void FNeutronMeshInterfaceBehavior::WakeMaterial()
+{
+	// Components that haven't started playing will wake up when their material is setup
+	if (MaterialOwner && !MaterialAwake && MaterialOwner->GetWorld())
+	{
+		UNeutronMaterializationSubsystem* Subsystem = MaterialOwner->GetWorld()->GetSubsystem<UNeutronMaterializationSubsystem>();
+		if (Subsystem)
+		{
+			Subsystem->Wake(MaterialOwner, this);
+		}
 	}
 }
 
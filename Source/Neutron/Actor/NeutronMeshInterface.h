@@ -42,6 +42,8 @@ struct NEUTRON_API FNeutronMeshInterfaceBehavior
 {
 	GENERATED_BODY()
 
+	friend class UNeutronMaterializationSubsystem;
+
 public:
 
 	FNeutronMeshInterfaceBehavior();
@@ -55,6 +57,9 @@ public:
 	/** Setup this behavior */
 	void SetupMaterial(class UPrimitiveComponent* Mesh, class UMaterialInterface* Material);
 
+	/** Register the mesh using this behavior for material updates, adopting its dynamic material if none was setup */
+	void SetMaterialOwner(class UPrimitiveComponent* Mesh);
+
 	/** Setup this behavior */
 	void SetupMaterial(class UDecalComponent* Decal, class UMaterialInterface* Material);
 
@@ -67,6 +72,9 @@ public:
 	/** Update this behavior */
 	void TickMaterial(float DeltaTime);
 
+	/** Check if the materialization or a parameter change is still in progress */
+	bool IsMaterialAnimating() const;
+
 	/** Start materializing the mesh, or force it visible entirely */
 	void Materialize(bool Force);
 
@@ -82,6 +90,11 @@ public:
 	/** Asynchronously set a color parameter */
 	void RequestParameter(FName Name, FLinearColor Value, bool Immediate = false);
 
+protected:
+
+	/** Get material updates from the materialization subsystem until the animations are complete */
+	void WakeMaterial();
+
 	/*----------------------------------------------------
 	    Properties
 	----------------------------------------------------*/
@@ -106,6 +119,10 @@ protected:
 	UPROPERTY()
 	class UMaterialInstanceDynamic* ComponentMaterial;
 
+	// Component owning this behavior, and whether it is updated by the materialization subsystem
+	class UActorComponent* MaterialOwner;
+	bool                   MaterialAwake;
+
 	// Materialization state
 	bool                                     CurrentMaterializationState;
 	float                                    CurrentMaterializationTime;
@@ -153,6 +170,10 @@ public:
 	/** Asynchronously set a color parameter */
 	virtual void RequestParameter(FName Name, FLinearColor Value, bool Immediate = false) = 0;
 
+	/** Apply the materialization state to the component after a material update */
+	virtual void OnMaterializationUpdated()
+	{}
+
 	/** Check the existence of a socket */
 	virtual bool HasSocket(FName SocketName) const
 	{
@@ -22,7 +22,6 @@ public:
 
 	UNeutronSkeletalMeshComponent()
 	{
-		PrimaryComponentTick.bCanEverTick = true;
 		SetRenderCustomDepth(true);
 	}
 
@@ -39,17 +38,9 @@ public:
 		{
 			FNeutronMeshInterfaceBehavior::SetupMaterial(this, CurrentMaterial);
 		}
-	}
-
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override
-	{
-		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-		FNeutronMeshInterfaceBehavior::TickMaterial(DeltaTime);
 
-		SetVisibility(CurrentMaterializationTime > 0);
-
-		bAffectDistanceFieldLighting = CurrentMaterializationTime >= 0.99f;
+		// Dynamic materials setup before play couldn't register for updates yet
+		FNeutronMeshInterfaceBehavior::SetMaterialOwner(this);
 	}
 
 	virtual void SetSkeletalMesh(USkeletalMesh* Mesh, bool bReinitPose = true) override
@@ -93,6 +84,13 @@ public:
 		FNeutronMeshInterfaceBehavior::RequestParameter(Name, Value, Immediate);
 	}
 
+	virtual void OnMaterializationUpdated() override
+	{
+		SetVisibility(CurrentMaterializationTime > 0);
+
+		bAffectDistanceFieldLighting = CurrentMaterializationTime >= 0.99f;
+	}
+
 	virtual bool HasSocket(FName SocketName) const override
 	{
 		return GetSocketByName(SocketName) != nullptr;
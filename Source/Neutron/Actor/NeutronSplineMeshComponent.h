@@ -22,7 +22,6 @@ public:
 
 	UNeutronSplineMeshComponent()
 	{
-		PrimaryComponentTick.bCanEverTick = true;
 		SetRenderCustomDepth(true);
 	}
 
@@ -37,17 +36,6 @@ public:
 		FNeutronMeshInterfaceBehavior::SetupMaterial(this, GetMaterial(0));
 	}
 
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override
-	{
-		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-		FNeutronMeshInterfaceBehavior::TickMaterial(DeltaTime);
-
-		SetVisibility(CurrentMaterializationTime > 0);
-
-		bAffectDistanceFieldLighting = CurrentMaterializationTime >= 0.99f;
-	}
-
 	virtual bool SetStaticMesh(UStaticMesh* Mesh) override
 	{
 		bool Changed = USplineMeshComponent::SetStaticMesh(Mesh);
@@ -89,4 +77,11 @@ public:
 	{
 		FNeutronMeshInterfaceBehavior::RequestParameter(Name, Value, Immediate);
 	}
+
+	virtual void OnMaterializationUpdated() override
+	{
+		SetVisibility(CurrentMaterializationTime > 0);
+
+		bAffectDistanceFieldLighting = CurrentMaterializationTime >= 0.99f;
+	}
 };
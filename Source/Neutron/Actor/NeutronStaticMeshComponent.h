@@ -23,7 +23,6 @@ public:
 
 	UNeutronStaticMeshComponent()
 	{
-		PrimaryComponentTick.bCanEverTick = true;
 		SetRenderCustomDepth(true);
 	}
 
@@ -40,17 +39,9 @@ public:
 		{
 			FNeutronMeshInterfaceBehavior::SetupMaterial(this, CurrentMaterial);
 		}
-	}
-
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override
-	{
-		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-		FNeutronMeshInterfaceBehavior::TickMaterial(DeltaTime);
 
-		SetVisibility(CurrentMaterializationTime > 0);
-
-		bAffectDistanceFieldLighting = CurrentMaterializationTime >= 0.99f;
+		// Dynamic materials setup before play couldn't register for updates yet
+		FNeutronMeshInterfaceBehavior::SetMaterialOwner(this);
 	}
 
 	virtual bool SetStaticMesh(UStaticMesh* Mesh) override
@@ -95,6 +86,13 @@ public:
 		FNeutronMeshInterfaceBehavior::RequestParameter(Name, Value, Immediate);
 	}
 
+	virtual void OnMaterializationUpdated() override
+	{
+		SetVisibility(CurrentMaterializationTime > 0);
+
+		bAffectDistanceFieldLighting = CurrentMaterializationTime >= 0.99f;
+	}
+
 	virtual bool HasSocket(FName SocketName) const override
 	{
 		return GetSocketByName(SocketName) != nullptr;
@@ -3,6 +3,7 @@
 #include "NeutronTurntablePawn.h"
 
 #include "Neutron/System/NeutronMenuManager.h"
+#include "Neutron/System/NeutronNetworkProfiler.h"
 #include "Neutron/UI/NeutronUI.h"
 #include "Neutron/Neutron.h"
 
@@ -56,7 +57,6 @@ ANeutronTurntablePawn::ANeutronTurntablePawn()
 	Camera->bUsePawnControlRotation = false;
 
 	// Settings
-	bAlwaysRelevant = true;
 	SetActorTickEnabled(true);
 	PrimaryActorTick.bCanEverTick          = true;
 	PrimaryActorTick.bStartWithTickEnabled = true;
@@ -71,6 +71,10 @@ ANeutronTurntablePawn::ANeutronTurntablePawn()
 	// Camera control defaults
 	CameraMinTilt = -85.0f;
 	CameraMaxTilt = 70.0f;
+
+	// Turntables are driven locally, other players don't need them
+	NetUpdatePolicy.OnlyRelevantToOwner = true;
+	NetUpdatePolicy.Initialize(this);
 }
 
 /*----------------------------------------------------
@@ -83,14 +87,38 @@ void ANeutronTurntablePawn::BeginPlay()
 
 	Super::BeginPlay();
 
+	NetUpdatePolicy.Initialize(this);
 	ResetView();
 	CameraYawComponent->SetAbsolute(false, true, false);
 }
 
+void ANeutronTurntablePawn::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	UNeutronNetworkProfiler::Get()->RecordReplication(this);
+}
+
+void ANeutronTurntablePawn::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	NetUpdatePolicy.MarkDirty(this);
+}
+
+void ANeutronTurntablePawn::UnPossessed()
+{
+	Super::UnPossessed();
+
+	NetUpdatePolicy.MarkDirty(this);
+}
+
 void ANeutronTurntablePawn::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	NetUpdatePolicy.Update(this, DeltaTime);
+
 	// Extract coordinates
 	const TPair<FVector, FVector> OriginExtent = GetTurntableBounds();
 	const FVector                 Origin       = OriginExtent.Key;
@@ -26,6 +26,12 @@ public:
 
 	virtual void Tick(float DeltaTime) override;
 
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	virtual void PossessedBy(AController* NewController) override;
+
+	virtual void UnPossessed() override;
+
 	/** Reset the view */
 	void ResetView();
 
@@ -94,6 +100,10 @@ public:
 	UPROPERTY(Category = Neutron, EditDefaultsOnly)
 	FNeutronCameraInputFilter CameraFilter;
 
+	// Replication settings
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	FNeutronNetUpdatePolicy NetUpdatePolicy;
+
 	/*----------------------------------------------------
 	    Components
 	----------------------------------------------------*/
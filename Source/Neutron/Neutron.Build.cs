@@ -26,7 +26,8 @@ public class Neutron : ModuleRules
 
 			"OnlineSubsystem",
 			"OnlineSubsystemUtils",
-			"NetCore"
+			"NetCore",
+			"Icmp"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[]
@@ -1,6 +1,7 @@
 // Neutron - Gwennaël Arbona
 
 #include "NeutronPlayerController.h"
+#include "NeutronTransitionCoordinator.h"
 
 #include "Neutron/Actor/NeutronActorTools.h"
 
@@ -10,6 +11,7 @@
 #include "Neutron/System/NeutronAssetManager.h"
 #include "Neutron/System/NeutronContractManager.h"
 #include "Neutron/System/NeutronMenuManager.h"
+#include "Neutron/System/NeutronNetworkProfiler.h"
 #include "Neutron/System/NeutronPostProcessManager.h"
 #include "Neutron/System/NeutronGameInstance.h"
 #include "Neutron/System/NeutronSaveManager.h"
@@ -35,13 +37,77 @@ ANeutronPlayerController::ANeutronPlayerController()
 	, LastNetworkError(ENeutronNetworkError::Success)
 	, CurrentCameraState(0)
 	, CurrentTimeInCameraState(0)
+	, TransitionCoordinator(nullptr)
 	, SharedTransitionActive(false)
-{}
+	, SharedTransitionGeneration(0)
+{
+	// Notification defaults
+	NotificationsPerSecond    = 2.0f;
+	NotificationDuration      = 5.0f;
+	MaxNotifications          = 5;
+	ShowNotificationsOnScreen = true;
+}
 
 /*----------------------------------------------------
     Inherited
 ----------------------------------------------------*/
 
+void ANeutronPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	NotificationQueue.Configure(NotificationsPerSecond, NotificationDuration, MaxNotifications);
+
+	if (IsLocalController())
+	{
+		GetGameInstance<UNeutronGameInstance>()->OnTravelComplete();
+	}
+
+	// Spawn the shared transition coordinator on the server, including dedicated ones
+	if (HasAuthority())
+	{
+		GetTransitionCoordinator();
+	}
+}
+
+void ANeutronPlayerController::PostSeamlessTravel()
+{
+	Super::PostSeamlessTravel();
+
+	// This player controller survived the travel, so reveal the game from here instead of BeginPlay
+	if (IsLocalController())
+	{
+		GetGameInstance<UNeutronGameInstance>()->OnTravelComplete();
+
+		UNeutronMenuManager* MenuManager = UNeutronMenuManager::Get();
+		if (!MenuManager->IsIdle())
+		{
+			MenuManager->CompleteAsyncAction();
+		}
+	}
+
+	// The coordinator stayed behind in the previous world, and BeginPlay won't run again
+	if (HasAuthority())
+	{
+		TransitionCoordinator = nullptr;
+		GetTransitionCoordinator();
+	}
+}
+
+void ANeutronPlayerController::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	UNeutronNetworkProfiler::Get()->RecordReplication(this);
+}
+
+bool ANeutronPlayerController::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UNeutronNetworkProfiler::Get()->RecordRPC(this, Function);
+
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
 void ANeutronPlayerController::PlayerTick(float DeltaTime)
 {
 	Super::PlayerTick(DeltaTime);
@@ -72,6 +138,20 @@ void ANeutronPlayerController::PlayerTick(float DeltaTime)
 		}
 
 		CurrentTimeInCameraState += DeltaTime;
+
+		// Show released notifications on screen, unless the project renders the queue itself
+		TArray<FNeutronNotification> NewNotifications;
+		NotificationQueue.Tick(DeltaTime);
+		NotificationQueue.ConsumeNewNotifications(NewNotifications);
+		if (ShowNotificationsOnScreen)
+		{
+			for (const FNeutronNotification& Notification : NewNotifications)
+			{
+				FString Count = Notification.Count > 1 ? FString::Printf(TEXT(" (x%d)"), Notification.Count) : FString();
+				NDIS("%s%s > %s / %s", *Notification.Text.ToString(), *Count, *Notification.Subtext.ToString(),
+					*GetEnumString(Notification.Type));
+			}
+		}
 	}
 }
 
@@ -85,13 +165,23 @@ void ANeutronPlayerController::SetGameOnline(bool Online, uint32 MaxPlayers)
 
 	if (UNeutronMenuManager::Get()->IsIdle())
 	{
-		UNeutronSoundManager::Get()->Mute();
+		// When the world stays loaded, keep the sound and fade back once listening, otherwise wait for the new level
+		const bool ListenInPlace = Online && GetGameInstance<UNeutronGameInstance>()->CanListenInPlace(GetWorld()->GetName());
+		if (!ListenInPlace)
+		{
+			UNeutronSoundManager::Get()->Mute();
+		}
 
-		UNeutronMenuManager::Get()->RunAction(ENeutronLoadingScreen::Launch,    //
+		UNeutronMenuManager::Get()->RunWaitAction(ENeutronLoadingScreen::Launch,
 			FNeutronAsyncAction::CreateLambda(
 				[=]()
 				{
 					GetGameInstance<UNeutronGameInstance>()->SetGameOnline(GetWorld()->GetName(), Online, MaxPlayers);
+				}),
+			FNeutronAsyncCondition::CreateLambda(
+				[=]()
+				{
+					return ListenInPlace && GetWorld()->GetNetMode() == NM_ListenServer;
 				}));
 	}
 }
@@ -186,6 +276,17 @@ bool ANeutronPlayerController::IsMenuOnly() const
 	return Cast<ANeutronWorldSettings>(GetWorld()->GetWorldSettings())->IsMenuMap();
 }
 
+void ANeutronPlayerController::Notify(const FText& Text, const FText& Subtext, ENeutronNotificationType Type)
+{
+	NLOG("ANeutronPlayerController::Notify : %s > %s / %s", *Text.ToString(), *Subtext.ToString(), *GetEnumString(Type));
+
+	// Only local players tick and display the queue
+	if (IsLocalController())
+	{
+		NotificationQueue.Push(Text, Subtext, Type);
+	}
+}
+
 /*----------------------------------------------------
     Shared transitions
 ----------------------------------------------------*/
@@ -196,84 +297,40 @@ void ANeutronPlayerController::SharedTransition(
 	NCHECK(GetLocalRole() == ROLE_Authority);
 	NLOG("ANeutronPlayerController::ServerSharedTransition");
 
-	for (ANeutronPlayerController* OtherPlayer : TActorRange<ANeutronPlayerController>(GetWorld()))
-	{
-		OtherPlayer->ClientStartSharedTransition(NewCameraState);
-	}
-
-	SharedTransitionStartAction  = StartAction;
-	SharedTransitionFinishAction = FinishAction;
-	SharedTransitionCondition    = Condition;
+	ANeutronTransitionCoordinator* Coordinator = GetTransitionCoordinator();
+	NCHECK(Coordinator);
+	Coordinator->StartTransition(NewCameraState, StartAction, Condition, FinishAction);
 }
 
-void ANeutronPlayerController::ClientStartSharedTransition_Implementation(uint8 NewCameraState)
+void ANeutronPlayerController::OnSharedTransitionStarted(uint8 NewCameraState, uint32 Generation)
 {
-	NLOG("ANeutronPlayerController::ClientStartSharedTransition_Implementation");
+	NLOG("ANeutronPlayerController::OnSharedTransitionStarted %d", Generation);
 
 	// Shared transitions work like this :
-	// - Server signals all players to fade to black through this very method
-	// - Once faded, Action is called and all players call ServerSharedTransitionReady() to signal they're dark
-	// - Server fires SharedTransitionStartAction when all clients have called ServerSharedTransitionReady()
-	// - Server fires SharedTransitionFinishAction once SharedTransitionCondition returns true on the server
-	// - Server then calls ClientStopSharedTransition() on all players so that they know to resume
+	// - Server multicasts the start of a new transition generation through the transition coordinator
+	// - All players fade to black, Action is called and they call ServerSharedTransitionReady() to signal they're dark
+	// - Coordinator fires the start action when all players have acknowledged, or after a timeout
+	// - Coordinator fires the finish action once the condition returns true on the server
+	// - Coordinator then multicasts the end of the transition so that all players know to resume
 	// - All players then fade back to the game
 
-	SharedTransitionActive = true;
+	SharedTransitionActive     = true;
+	SharedTransitionGeneration = Generation;
 
 	// Action : mark as in shared transition locally and remotely
 	FNeutronAsyncAction Action = FNeutronAsyncAction::CreateLambda(
 		[=]()
 		{
 			SetCameraState(NewCameraState);
-			ServerSharedTransitionReady();
-			NLOG("ANeutronPlayerController::ClientStartSharedTransition_Implementation : done, waiting for server");
+			ServerSharedTransitionReady(Generation);
+			NLOG("ANeutronPlayerController::OnSharedTransitionStarted : done, waiting for server");
 		});
 
-	// Condition : on server, when all clients have reported as ready
-	// On client, when the server has signaled to stop
+	// Condition : when the server has signaled to stop
 	FNeutronAsyncCondition Condition = FNeutronAsyncCondition::CreateLambda(
 		[=]()
 		{
-			if (GetLocalRole() == ROLE_Authority)
-			{
-				// Check if all players are in transition
-				bool AllPlayersInTransition = true;
-				for (ANeutronPlayerController* OtherPlayer : TActorRange<ANeutronPlayerController>(GetWorld()))
-				{
-					if (!OtherPlayer->SharedTransitionActive)
-					{
-						AllPlayersInTransition = false;
-						break;
-					}
-				}
-
-				// Once all players are in the transition, fire the start event, wait for the condition, fire the end event, and stop
-				if (AllPlayersInTransition)
-				{
-					SharedTransitionStartAction.ExecuteIfBound();
-					SharedTransitionStartAction.Unbind();
-
-					if (!SharedTransitionCondition.IsBound() || SharedTransitionCondition.Execute())
-					{
-						SharedTransitionFinishAction.ExecuteIfBound();
-						SharedTransitionFinishAction.Unbind();
-						SharedTransitionCondition.Unbind();
-
-						for (ANeutronPlayerController* OtherPlayer : TActorRange<ANeutronPlayerController>(GetWorld()))
-						{
-							OtherPlayer->ClientStopSharedTransition();
-						}
-
-						return true;
-					}
-				}
-
-				return false;
-			}
-			else
-			{
-				return !SharedTransitionActive;
-			}
+			return !SharedTransitionActive;
 		});
 
 	// Run the process
@@ -287,19 +344,26 @@ void ANeutronPlayerController::ClientStartSharedTransition_Implementation(uint8
 	}
 }
 
-void ANeutronPlayerController::ClientStopSharedTransition_Implementation()
+void ANeutronPlayerController::OnSharedTransitionStopped(uint32 Generation)
 {
-	NLOG("ANeutronPlayerController::ClientStopSharedTransition_Implementation");
+	NLOG("ANeutronPlayerController::OnSharedTransitionStopped %d", Generation);
 
-	SharedTransitionActive = false;
+	if (Generation == SharedTransitionGeneration)
+	{
+		SharedTransitionActive = false;
+	}
 }
 
-void ANeutronPlayerController::ServerSharedTransitionReady_Implementation()
+void ANeutronPlayerController::ServerSharedTransitionReady_Implementation(uint32 Generation)
 {
 	NCHECK(GetLocalRole() == ROLE_Authority);
-	NLOG("ANeutronPlayerController::ServerSharedTransitionReady_Implementation");
+	NLOG("ANeutronPlayerController::ServerSharedTransitionReady_Implementation %d", Generation);
 
-	SharedTransitionActive = true;
+	ANeutronTransitionCoordinator* Coordinator = GetTransitionCoordinator();
+	if (Coordinator)
+	{
+		Coordinator->OnPlayerReady(this, Generation);
+	}
 }
 
 /*----------------------------------------------------
@@ -351,13 +415,34 @@ void ANeutronPlayerController::AnyKey(FKey Key)
 	UNeutronMenuManager::Get()->SetUsingGamepad(Key.IsGamepadKey());
 }
 
+/*----------------------------------------------------
+    Internals
+----------------------------------------------------*/
+
+ANeutronTransitionCoordinator* ANeutronPlayerController::GetTransitionCoordinator()
+{
+	if (!IsValid(TransitionCoordinator))
+	{
+		TActorIterator<ANeutronTransitionCoordinator> Iterator(GetWorld());
+		TransitionCoordinator = Iterator ? *Iterator : nullptr;
+
+		// The server owns the coordinator, whichever controller needs it first
+		if (TransitionCoordinator == nullptr && HasAuthority())
+		{
+			TransitionCoordinator = GetWorld()->SpawnActor<ANeutronTransitionCoordinator>();
+		}
+	}
+
+	return TransitionCoordinator;
+}
+
 /*----------------------------------------------------
     Test code
 ----------------------------------------------------*/
 
 #if WITH_EDITOR
 
-void ANeutronPlayerController::OnJoinRandomFriend(TArray<TSharedRef<FOnlineFriend>> FriendList)
+void ANeutronPlayerController::OnJoinRandomFriend(const TArray<TSharedRef<FOnlineFriend>>& FriendList)
 {
 	for (auto Friend : FriendList)
 	{
@@ -386,6 +471,9 @@ void ANeutronPlayerController::OnJoinRandomSession(TArray<FOnlineSessionSearchRe
 
 						UNeutronSessionsManager::Get()->JoinSearchResult(Result);
 					}));
+
+			// Results are ranked, so the first one is the best host
+			break;
 		}
 	}
 }
@@ -5,6 +5,7 @@
 #include "Neutron/System/NeutronGameInstance.h"
 #include "Neutron/System/NeutronPostProcessManager.h"
 #include "Neutron/UI/NeutronUI.h"
+#include "Neutron/UI/NeutronNotificationQueue.h"
 
 #include "CoreMinimal.h"
 #include "Online.h"
@@ -32,8 +33,16 @@ public:
 	    Inherited
 	----------------------------------------------------*/
 
+	virtual void BeginPlay() override;
+
 	virtual void PlayerTick(float DeltaTime) override;
 
+	virtual void PostSeamlessTravel() override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+
 	/*----------------------------------------------------
 	    Game flow
 	----------------------------------------------------*/
@@ -82,10 +91,13 @@ public:
 		return true;
 	}
 
-	/** Show a text notification on the screen */
-	virtual void Notify(const FText& Text, const FText& Subtext = FText(), ENeutronNotificationType Type = ENeutronNotificationType::Info)
+	/** Queue a text notification for display on the screen */
+	virtual void Notify(const FText& Text, const FText& Subtext = FText(), ENeutronNotificationType Type = ENeutronNotificationType::Info);
+
+	/** Get the notification queue, for the overlay to render as a single list */
+	const FNeutronNotificationQueue& GetNotifications() const
 	{
-		NDIS("%s > %s / %s", *Text.ToString(), *Subtext.ToString(), *GetEnumString(Type));
+		return NotificationQueue;
 	}
 
 	/*----------------------------------------------------
@@ -104,17 +116,15 @@ public:
 	void SharedTransition(
 		uint8 NewCameraState, FNeutronAsyncAction StartAction, FNeutronAsyncCondition Condition, FNeutronAsyncAction FinishAction);
 
-	/** Signal a client that a shared transition is starting */
-	UFUNCTION(Client, Reliable)
-	void ClientStartSharedTransition(uint8 NewCameraState);
+	/** A shared transition is starting on the local player */
+	void OnSharedTransitionStarted(uint8 NewCameraState, uint32 Generation);
 
-	/** Signal a client that the transition is complete */
-	UFUNCTION(Client, Reliable)
-	void ClientStopSharedTransition();
+	/** The shared transition is complete */
+	void OnSharedTransitionStopped(uint32 Generation);
 
 	/** Signal the server that the transition is ready */
 	UFUNCTION(Server, Reliable)
-	void ServerSharedTransitionReady();
+	void ServerSharedTransitionReady(uint32 Generation);
 
 	/** Check if the player is currently in a shared transition */
 	UFUNCTION(Category = Nova, BlueprintCallable)
@@ -173,12 +183,43 @@ public:
 #if WITH_EDITOR
 
 	// Test
-	void OnJoinRandomFriend(TArray<TSharedRef<FOnlineFriend>> FriendList);
+	void OnJoinRandomFriend(const TArray<TSharedRef<FOnlineFriend>>& FriendList);
 	void OnJoinRandomSession(TArray<FOnlineSessionSearchResult> SessionList);
 	void TestJoin();
 
 #endif
 
+	/*----------------------------------------------------
+	    Internals
+	----------------------------------------------------*/
+
+protected:
+
+	/** Get the shared transition coordinator in this world, spawning it on the server if needed */
+	class ANeutronTransitionCoordinator* GetTransitionCoordinator();
+
+	/*----------------------------------------------------
+	    Properties
+	----------------------------------------------------*/
+
+public:
+
+	// Number of new notifications that can be displayed per second
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float NotificationsPerSecond;
+
+	// Time in seconds a notification stays displayed
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float NotificationDuration;
+
+	// Maximum number of notifications displayed at once
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	int32 MaxNotifications;
+
+	// Print released notifications to the screen, for projects without a notification overlay
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool ShowNotificationsOnScreen;
+
 	/*----------------------------------------------------
 	    Data
 	----------------------------------------------------*/
@@ -190,9 +231,13 @@ private:
 	uint8                CurrentCameraState;
 	float                CurrentTimeInCameraState;
 
+	// Notifications
+	FNeutronNotificationQueue NotificationQueue;
+
 	// Transitions
-	bool                   SharedTransitionActive;
-	FNeutronAsyncAction    SharedTransitionStartAction;
-	FNeutronAsyncAction    SharedTransitionFinishAction;
-	FNeutronAsyncCondition SharedTransitionCondition;
+	UPROPERTY()
+	class ANeutronTransitionCoordinator* TransitionCoordinator;
+
+	bool   SharedTransitionActive;
+	uint32 SharedTransitionGeneration;
 };
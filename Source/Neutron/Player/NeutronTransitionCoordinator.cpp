@@ -0,0 +1,153 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronTransitionCoordinator.h"
+#include "NeutronPlayerController.h"
+
+#include "Neutron/System/NeutronNetworkProfiler.h"
+#include "Neutron/Neutron.h"
+
+#include "Engine/World.h"
+
+/*----------------------------------------------------
+    Constructor
+----------------------------------------------------*/
+
+ANeutronTransitionCoordinator::ANeutronTransitionCoordinator()
+	: Super()
+	, CurrentGeneration(0)
+	, TransitionActive(false)
+	, StartActionFired(false)
+	, TransitionStartTime(0)
+	, ExpectedPlayerCount(0)
+{
+	// Settings
+	ReadyTimeout = 10.0f;
+
+	// Replication, only active around transitions
+	bReplicates     = true;
+	bAlwaysRelevant = true;
+	NetUpdatePolicy.Initialize(this);
+
+	PrimaryActorTick.bCanEverTick        = true;
+	PrimaryActorTick.bTickEvenWhenPaused = true;
+}
+
+/*----------------------------------------------------
+    Gameplay
+----------------------------------------------------*/
+
+void ANeutronTransitionCoordinator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	NetUpdatePolicy.Update(this, DeltaTime);
+
+	if (!HasAuthority() || !TransitionActive)
+	{
+		return;
+	}
+
+	// Wait for all players to be in the dark, or leave stragglers behind
+	if (!StartActionFired)
+	{
+		bool TimedOut = FPlatformTime::Seconds() - TransitionStartTime > ReadyTimeout;
+		if (ReadyPlayers.Num() < ExpectedPlayerCount && !TimedOut)
+		{
+			return;
+		}
+		else if (TimedOut)
+		{
+			NERR("ANeutronTransitionCoordinator::Tick : %d/%d players ready after %.1fs, proceeding", ReadyPlayers.Num(),
+				ExpectedPlayerCount, ReadyTimeout);
+		}
+
+		StartAction.ExecuteIfBound();
+		StartAction.Unbind();
+		StartActionFired = true;
+	}
+
+	// Release everyone once the condition is met
+	if (!Condition.IsBound() || Condition.Execute())
+	{
+		NLOG("ANeutronTransitionCoordinator::Tick : transition %d complete", CurrentGeneration);
+
+		FinishAction.ExecuteIfBound();
+		FinishAction.Unbind();
+		Condition.Unbind();
+
+		TransitionActive = false;
+		ReadyPlayers.Empty();
+
+		MulticastStopTransition(CurrentGeneration);
+		NetUpdatePolicy.MarkDirty(this);
+	}
+}
+
+void ANeutronTransitionCoordinator::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	UNeutronNetworkProfiler::Get()->RecordReplication(this);
+}
+
+bool ANeutronTransitionCoordinator::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UNeutronNetworkProfiler::Get()->RecordRPC(this, Function);
+
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void ANeutronTransitionCoordinator::StartTransition(
+	uint8 NewCameraState, FNeutronAsyncAction NewStartAction, FNeutronAsyncCondition NewCondition, FNeutronAsyncAction NewFinishAction)
+{
+	NCHECK(HasAuthority());
+
+	CurrentGeneration++;
+	TransitionActive    = true;
+	StartActionFired    = false;
+	TransitionStartTime = FPlatformTime::Seconds();
+	ExpectedPlayerCount = GetWorld()->GetNumPlayerControllers();
+	ReadyPlayers.Empty();
+
+	StartAction  = NewStartAction;
+	Condition    = NewCondition;
+	FinishAction = NewFinishAction;
+
+	NLOG("ANeutronTransitionCoordinator::StartTransition : transition %d for %d players", CurrentGeneration, ExpectedPlayerCount);
+
+	MulticastStartTransition(NewCameraState, CurrentGeneration);
+	NetUpdatePolicy.MarkDirty(this);
+}
+
+void ANeutronTransitionCoordinator::OnPlayerReady(const ANeutronPlayerController* Player, uint32 Generation)
+{
+	NCHECK(HasAuthority());
+
+	// Acknowledgements from a previous transition are ignored
+	if (TransitionActive && Generation == CurrentGeneration)
+	{
+		ReadyPlayers.Add(Player);
+	}
+}
+
+/*----------------------------------------------------
+    Networking
+----------------------------------------------------*/
+
+void ANeutronTransitionCoordinator::MulticastStartTransition_Implementation(uint8 NewCameraState, uint32 Generation)
+{
+	ANeutronPlayerController* PC = Cast<ANeutronPlayerController>(GetGameInstance()->GetFirstLocalPlayerController());
+	if (PC)
+	{
+		PC->OnSharedTransitionStarted(NewCameraState, Generation);
+	}
+}
+
+void ANeutronTransitionCoordinator::MulticastStopTransition_Implementation(uint32 Generation)
+{
+	ANeutronPlayerController* PC = Cast<ANeutronPlayerController>(GetGameInstance()->GetFirstLocalPlayerController());
+	if (PC)
+	{
+		PC->OnSharedTransitionStopped(Generation);
+	}
+}
@@ -0,0 +1,91 @@
+// Neutron - Gwennaël Arbona
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Neutron/Actor/NeutronActorTools.h"
+#include "Neutron/UI/NeutronUI.h"
+
+#include "NeutronTransitionCoordinator.generated.h"
+
+/** Replicated barrier for shared transitions, counting player acknowledgements on the server and releasing all players at once */
+UCLASS(ClassGroup = (Neutron), NotPlaceable)
+class NEUTRON_API ANeutronTransitionCoordinator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	ANeutronTransitionCoordinator();
+
+	/*----------------------------------------------------
+	    Gameplay
+	----------------------------------------------------*/
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+
+	/** Start a new shared transition on all players */
+	void StartTransition(
+		uint8 NewCameraState, FNeutronAsyncAction StartAction, FNeutronAsyncCondition Condition, FNeutronAsyncAction FinishAction);
+
+	/** Register the acknowledgement of a player that has faded to black */
+	void OnPlayerReady(const class ANeutronPlayerController* Player, uint32 Generation);
+
+	/** Check if a transition is ongoing on the server */
+	bool IsTransitionActive() const
+	{
+		return TransitionActive;
+	}
+
+	/*----------------------------------------------------
+	    Networking
+	----------------------------------------------------*/
+
+protected:
+
+	/** Signal all players that a shared transition is starting */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastStartTransition(uint8 NewCameraState, uint32 Generation);
+
+	/** Signal all players that the transition is complete */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastStopTransition(uint32 Generation);
+
+	/*----------------------------------------------------
+	    Properties
+	----------------------------------------------------*/
+
+public:
+
+	// Time in seconds after which players that haven't faded to black are left behind
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float ReadyTimeout;
+
+	// Replication settings
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	FNeutronNetUpdatePolicy NetUpdatePolicy;
+
+	/*----------------------------------------------------
+	    Data
+	----------------------------------------------------*/
+
+protected:
+
+	// Transition state
+	uint32                                      CurrentGeneration;
+	bool                                        TransitionActive;
+	bool                                        StartActionFired;
+	double                                      TransitionStartTime;
+	int32                                       ExpectedPlayerCount;
+	TSet<const class ANeutronPlayerController*> ReadyPlayers;
+
+	// Transition callbacks
+	FNeutronAsyncAction    StartAction;
+	FNeutronAsyncAction    FinishAction;
+	FNeutronAsyncCondition Condition;
+};
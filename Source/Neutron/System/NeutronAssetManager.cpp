@@ -133,12 +133,12 @@ void UNeutronAssetManager::Initialize(class UNeutronGameInstance* GameInstance)
 	}
 }
 
-void UNeutronAssetManager::LoadAsset(FSoftObjectPath Asset, FStreamableDelegate Callback)
+void UNeutronAssetManager::LoadAsset(FSoftObjectPath Asset, FStreamableDelegate Callback, bool Background)
 {
 	TArray<FSoftObjectPath> Assets;
 	Assets.Add(Asset);
 
-	StreamableManager.RequestAsyncLoad(Assets, Callback);
+	LoadAssets(Assets, Callback, Background);
 }
 
 void UNeutronAssetManager::LoadAssets(TArray<FSoftObjectPath> Assets)
@@ -149,12 +149,53 @@ void UNeutronAssetManager::LoadAssets(TArray<FSoftObjectPath> Assets)
 	}
 }
 
-void UNeutronAssetManager::LoadAssets(TArray<FSoftObjectPath> Assets, FStreamableDelegate Callback)
+void UNeutronAssetManager::LoadAssets(TArray<FSoftObjectPath> Assets, FStreamableDelegate Callback, bool Background)
 {
-	StreamableManager.RequestAsyncLoad(Assets, Callback);
+	TArray<TWeakPtr<FStreamableHandle>>& Handles = Background ? BackgroundLoadHandles : LoadHandles;
+
+	// Forget about finished loads
+	Handles.RemoveAll(
+		[](const TWeakPtr<FStreamableHandle>& Handle)
+		{
+			TSharedPtr<FStreamableHandle> PinnedHandle = Handle.Pin();
+			return !PinnedHandle.IsValid() || !PinnedHandle->IsLoadingInProgress();
+		});
+
+	// Track loads in flight so that readiness checks can wait for them, no handle means there was nothing to load
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(Assets, Callback);
+	if (Handle.IsValid())
+	{
+		Handles.Add(Handle);
+	}
+}
+
+/** Check if any of these loads is still in progress */
+static bool AreLoadsInProgress(const TArray<TWeakPtr<FStreamableHandle>>& Handles)
+{
+	for (const TWeakPtr<FStreamableHandle>& Handle : Handles)
+	{
+		TSharedPtr<FStreamableHandle> PinnedHandle = Handle.Pin();
+		if (PinnedHandle.IsValid() && PinnedHandle->IsLoadingInProgress())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UNeutronAssetManager::IsLoading() const
+{
+	return AreLoadsInProgress(LoadHandles);
+}
+
+bool UNeutronAssetManager::IsLoadingInBackground() const
+{
+	return AreLoadsInProgress(BackgroundLoadHandles);
 }
 
 void UNeutronAssetManager::UnloadAsset(FSoftObjectPath Asset)
 {
 	StreamableManager.Unload(Asset);
 }
+
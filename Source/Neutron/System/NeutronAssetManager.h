@@ -197,18 +197,24 @@ public:
 		}
 	}
 
-	/** Load an asset asynchronously */
-	void LoadAsset(FSoftObjectPath Entry, FStreamableDelegate Callback);
+	/** Load an asset asynchronously, background loads don't count as loading */
+	void LoadAsset(FSoftObjectPath Entry, FStreamableDelegate Callback, bool Background = false);
 
 	/** Load a collection of assets synchronously */
 	void LoadAssets(TArray<FSoftObjectPath> Assets);
 
-	/** Load a collection of assets asynchronously */
-	void LoadAssets(TArray<FSoftObjectPath> Assets, FStreamableDelegate Callback);
+	/** Load a collection of assets asynchronously, background loads don't count as loading */
+	void LoadAssets(TArray<FSoftObjectPath> Assets, FStreamableDelegate Callback, bool Background = false);
 
 	/** Unload an asset asynchronously */
 	void UnloadAsset(FSoftObjectPath Asset);
 
+	/** Check if asynchronous loads are still in progress */
+	bool IsLoading() const;
+
+	/** Check if background loads are still in progress */
+	bool IsLoadingInBackground() const;
+
 	/*----------------------------------------------------
 	    Public data
 	----------------------------------------------------*/
@@ -225,5 +231,7 @@ public:
 	TMap<TSubclassOf<UNeutronAssetDescription>, const UNeutronAssetDescription*> DefaultAssets;
 
 	// Asynchronous asset loader
-	FStreamableManager StreamableManager;
+	FStreamableManager                  StreamableManager;
+	TArray<TWeakPtr<FStreamableHandle>> LoadHandles;
+	TArray<TWeakPtr<FStreamableHandle>> BackgroundLoadHandles;
 };
@@ -2,11 +2,14 @@
 
 #include "NeutronContractManager.h"
 #include "NeutronGameInstance.h"
+#include "NeutronMenuManager.h"
 #include "NeutronSaveManager.h"
 
 #include "Neutron/Player/NeutronPlayerController.h"
 #include "Neutron/Neutron.h"
 
+#include "Async/ParallelFor.h"
+
 #define LOCTEXT_NAMESPACE "UNeutronContractManager"
 
 // Statics
@@ -99,6 +102,8 @@ void UNeutronContractManager::Load(const FNeutronContractManagerSave& SaveData)
 
 		CurrentTrackedContract = INDEX_NONE;
 	}
+
+	UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Contracts);
 }
 
 /*----------------------------------------------------
@@ -131,9 +136,49 @@ void UNeutronContractManager::BeginPlay(ANeutronPlayerController* PC, FNeutronCo
 void UNeutronContractManager::OnEvent(FNeutronContractEvent Event)
 {
 	TArray<TSharedPtr<FNeutronContract>> SafeCurrentContracts = CurrentContracts;
-	for (TSharedPtr<FNeutronContract> Contract : SafeCurrentContracts)
+
+	// Evaluate thread-safe contracts in parallel, one task per contract
+	ParallelContracts.Reset();
+	for (const TSharedPtr<FNeutronContract>& Contract : SafeCurrentContracts)
+	{
+		if (Contract->IsThreadSafe())
+		{
+			ParallelContracts.Add(Contract.Get());
+		}
+	}
+	if (ParallelContracts.Num() > 1)
+	{
+		ParallelFor(ParallelContracts.Num(),
+			[&](int32 Index)
+			{
+				ParallelContracts[Index]->OnEvent(Event);
+			});
+	}
+	else if (ParallelContracts.Num() == 1)
 	{
-		Contract->OnEvent(Event);
+		ParallelContracts[0]->OnEvent(Event);
+	}
+
+	// Apply the results and evaluate the remaining contracts on the game thread, in contract order
+	for (const TSharedPtr<FNeutronContract>& Contract : SafeCurrentContracts)
+	{
+		if (Contract->IsThreadSafe())
+		{
+			FNeutronContractEventResult Result = Contract->ConsumeEventResult();
+
+			if (Result.Progressed)
+			{
+				ProgressContract(Contract);
+			}
+			if (Result.Completed)
+			{
+				CompleteContract(Contract);
+			}
+		}
+		else
+		{
+			Contract->OnEvent(Event);
+		}
 	}
 }
 
@@ -156,6 +201,7 @@ void UNeutronContractManager::AcceptContract()
 
 	CurrentContracts.Add(GeneratedContract);
 	GeneratedContract.Reset();
+	UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Contracts);
 
 	PlayerController->Notify(LOCTEXT("ContractAccepted", "Contract accepted"), FText(), ENeutronNotificationType::Info);
 }
@@ -171,6 +217,8 @@ void UNeutronContractManager::ProgressContract(TSharedPtr<class FNeutronContract
 {
 	NLOG("UNeutronContractManager::ProgressContract");
 
+	UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Contracts);
+
 	PlayerController->Notify(LOCTEXT("ContractUpdated", "Contract updated"), FText(), ENeutronNotificationType::Info);
 }
 
@@ -179,6 +227,7 @@ void UNeutronContractManager::CompleteContract(TSharedPtr<class FNeutronContract
 	NLOG("UNeutronContractManager::CompleteContract");
 
 	CurrentContracts.Remove(Contract);
+	UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Contracts);
 
 	PlayerController->Notify(LOCTEXT("ContractComplete", "Contract complete"), FText(), ENeutronNotificationType::Info);
 }
@@ -200,6 +249,7 @@ void UNeutronContractManager::SetTrackedContract(int32 Index)
 	NLOG("UNeutronContractManager::SetTrackedContract %d", Index);
 
 	CurrentTrackedContract = Index;
+	UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Contracts);
 
 	if (Index >= 0)
 	{
@@ -222,6 +272,7 @@ void UNeutronContractManager::AbandonContract(int32 Index)
 	{
 		CurrentTrackedContract = INDEX_NONE;
 	}
+	UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Contracts);
 
 	PlayerController->Notify(LOCTEXT("ContractAbandoned", "Contract abandoned"), FText(), ENeutronNotificationType::Info);
 }
@@ -41,6 +41,16 @@ struct FNeutronContractEvent
 	ENeutronContratEventType Type;
 };
 
+/** Contract updates requested by thread-safe contracts, applied on the game thread */
+struct FNeutronContractEventResult
+{
+	FNeutronContractEventResult() : Progressed(false), Completed(false)
+	{}
+
+	bool Progressed;
+	bool Completed;
+};
+
 /** Save data */
 USTRUCT()
 struct FNeutronContractManagerSave
@@ -97,12 +107,42 @@ public:
 	/** Update this contract */
 	virtual void OnEvent(const FNeutronContractEvent& Event){};
 
+	/** Check if OnEvent only reads the world and this contract's own state, allowing it to run off the game thread.
+	    Such contracts must not call the contract manager directly, and use RequestProgress & RequestCompletion instead. */
+	virtual bool IsThreadSafe() const
+	{
+		return false;
+	}
+
+	/** Get and reset the updates requested during the last event */
+	FNeutronContractEventResult ConsumeEventResult()
+	{
+		FNeutronContractEventResult Result = PendingResult;
+		PendingResult                      = FNeutronContractEventResult();
+		return Result;
+	}
+
+protected:
+
+	/** Signal progress from a thread-safe contract */
+	void RequestProgress()
+	{
+		PendingResult.Progressed = true;
+	}
+
+	/** Signal completion from a thread-safe contract */
+	void RequestCompletion()
+	{
+		PendingResult.Completed = true;
+	}
+
 protected:
 
 	// Local state
 	ENeutronContractType        Type;
 	FNeutronContractDetails     Details;
 	class UNeutronGameInstance* GameInstance;
+	FNeutronContractEventResult PendingResult;
 };
 
 /*----------------------------------------------------
@@ -227,4 +267,7 @@ protected:
 	TSharedPtr<class FNeutronContract>         GeneratedContract;
 	TArray<TSharedPtr<class FNeutronContract>> CurrentContracts;
 	int32                                      CurrentTrackedContract;
+
+	// Thread-safe contracts, evaluated in parallel
+	TArray<class FNeutronContract*> ParallelContracts;
 };
@@ -5,10 +5,12 @@
 #include "NeutronAssetManager.h"
 #include "NeutronContractManager.h"
 #include "NeutronMenuManager.h"
+#include "NeutronNetworkProfiler.h"
 #include "NeutronPostProcessManager.h"
 #include "NeutronSoundManager.h"
 #include "NeutronSaveManager.h"
 #include "NeutronSessionsManager.h"
+#include "NeutronSessionHarness.h"
 
 #include "Neutron/Settings/NeutronGameUserSettings.h"
 #include "Neutron/Settings/NeutronWorldSettings.h"
@@ -18,6 +20,7 @@
 #include "Neutron/Neutron.h"
 
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameModeBase.h"
 #include "GameMapsSettings.h"
 #include "Engine/NetDriver.h"
 #include "Engine/World.h"
@@ -29,8 +32,11 @@
     Constructor
 ----------------------------------------------------*/
 
-UNeutronGameInstance::UNeutronGameInstance() : Super()
-{}
+UNeutronGameInstance::UNeutronGameInstance() : Super(), TravelStartTime(0)
+{
+	// Settings
+	UseSeamlessTravel = false;
+}
 
 /*----------------------------------------------------
     Inherited
@@ -81,6 +87,22 @@ void UNeutronGameInstance::Init()
 	SoundManager = NewObject<UNeutronSoundManager>(this, UNeutronSoundManager::StaticClass(), TEXT("SoundManager"));
 	NCHECK(SoundManager);
 	SoundManager->Initialize(this);
+
+	// Create the network profiler
+	NetworkProfiler = NewObject<UNeutronNetworkProfiler>(this, UNeutronNetworkProfiler::StaticClass(), TEXT("NetworkProfiler"));
+	NCHECK(NetworkProfiler);
+	NetworkProfiler->Initialize(this);
+
+#if !UE_BUILD_SHIPPING
+
+	// Create the session test harness if requested on the command line
+	if (FNeutronSessionHarness::IsRequested())
+	{
+		SessionHarness = MakeShared<FNeutronSessionHarness>();
+		SessionHarness->Initialize(this);
+	}
+
+#endif
 }
 
 void UNeutronGameInstance::Shutdown()
@@ -107,6 +129,7 @@ void UNeutronGameInstance::SetGameOnline(FString URL, bool Online, uint32 MaxPla
 	NLOG("UNeutronGameInstance::SetGameOnline : '%s', online = %d, players = %d", *URL, Online, MaxPlayerCount);
 
 	SessionsManager->ClearErrors();
+	TravelStartTime = FPlatformTime::Seconds();
 
 	// We want to be online and presumably aren't, start a new online session and then travel to the level
 	if (Online)
@@ -132,13 +155,56 @@ void UNeutronGameInstance::GoToMainMenu()
 	NLOG("UNeutronGameInstance::GoToMainMenu");
 
 	UNeutronSaveManager::Get()->ReleaseCurrentSaveData();
+	TravelStartTime = FPlatformTime::Seconds();
 
 	UGameplayStatics::OpenLevel(GetWorld(), FName(*UGameMapsSettings::GetGameDefaultMap()), true);
 }
 
 void UNeutronGameInstance::ServerTravel(FString URL)
 {
+	NLOG("UNeutronGameInstance::ServerTravel : '%s', seamless = %d", *URL, UseSeamlessTravel);
+
+	TravelStartTime = FPlatformTime::Seconds();
+
+	// Seamless travel isn't supported in the editor
+	AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+	if (GameMode)
+	{
+		GameMode->bUseSeamlessTravel = UseSeamlessTravel && !GetWorld()->IsPlayInEditor();
+	}
+
 	GetWorld()->ServerTravel(URL + TEXT("?listen"), true);
 }
 
+bool UNeutronGameInstance::CanListenInPlace(const FString& URL) const
+{
+	return UseSeamlessTravel && URL == GetWorld()->GetName() && GetWorld()->GetNetMode() == NM_Standalone;
+}
+
+bool UNeutronGameInstance::ListenInPlace()
+{
+	FURL ListenURL;
+	if (GetWorld()->Listen(ListenURL))
+	{
+		NLOG("UNeutronGameInstance::ListenInPlace : listening on '%s'", *GetWorld()->GetName());
+
+		OnTravelComplete();
+		return true;
+	}
+	else
+	{
+		NERR("UNeutronGameInstance::ListenInPlace : failed to listen, reloading the level");
+		return false;
+	}
+}
+
+void UNeutronGameInstance::OnTravelComplete()
+{
+	if (TravelStartTime > 0)
+	{
+		NLOG("UNeutronGameInstance::OnTravelComplete : travel took %.2fs", FPlatformTime::Seconds() - TravelStartTime);
+		TravelStartTime = 0;
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -39,6 +39,26 @@ public:
 	/** Change level on the server */
 	void ServerTravel(FString URL);
 
+	/** Check if going online with URL can keep the current world loaded */
+	bool CanListenInPlace(const FString& URL) const;
+
+	/** Start listening for clients on the current world, return false if a full travel is needed */
+	bool ListenInPlace();
+
+	/** Report that the player is back in control after a travel */
+	void OnTravelComplete();
+
+	/*----------------------------------------------------
+	    Properties
+	----------------------------------------------------*/
+
+public:
+
+	// Keep the world, managers and player controller alive when going online or changing levels on the server
+	// The transition map is the project's Maps & Modes setting, an empty world is used when none is set
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool UseSeamlessTravel;
+
 private:
 
 	/*----------------------------------------------------
@@ -72,4 +92,18 @@ private:
 	// Sound manager object
 	UPROPERTY()
 	class UNeutronSoundManager* SoundManager;
+
+	// Network profiler object
+	UPROPERTY()
+	class UNeutronNetworkProfiler* NetworkProfiler;
+
+#if !UE_BUILD_SHIPPING
+
+	// Session test harness, only created on demand
+	TSharedPtr<class FNeutronSessionHarness> SessionHarness;
+
+#endif
+
+	// Time at which the current travel started
+	double TravelStartTime;
 };
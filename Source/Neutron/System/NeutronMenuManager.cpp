@@ -6,27 +6,118 @@
 #include "Neutron/Player/NeutronPlayerController.h"
 
 #include "Neutron/Settings/NeutronWorldSettings.h"
+#include "Neutron/System/NeutronAssetManager.h"
 
 #include "Neutron/UI/NeutronUI.h"
 #include "Neutron/UI/Widgets/NeutronMenu.h"
 #include "Neutron/UI/Widgets/NeutronButton.h"
+#include "Neutron/UI/Widgets/NeutronTabView.h"
 
 #include "Neutron/Neutron.h"
 
 #include "Framework/Application/SlateApplication.h"
 #include "Engine/Console.h"
+#include "Engine/LevelStreaming.h"
+#include "ShaderCompiler.h"
 #include "Engine.h"
 
 // Statics
 UNeutronMenuManager* UNeutronMenuManager::Singleton = nullptr;
 
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Game menu updates"), STAT_NeutronGameMenuUpdates, STATGROUP_Tickables);
+
+// Console interface
+static FAutoConsoleCommand NeutronMenuStatsCommand(TEXT("neutron.MenuStats"), TEXT("Log the update cost of Neutron game menus"),
+	FConsoleCommandDelegate::CreateLambda(
+		[]()
+		{
+			if (UNeutronMenuManager::Get())
+			{
+				UNeutronMenuManager::Get()->DumpGameMenuStatistics();
+			}
+		}));
+
+/*----------------------------------------------------
+    Game menu entry
+----------------------------------------------------*/
+
+bool FNeutronGameMenuEntry::IsVisible() const
+{
+	return (!IsWidgetDisplayed || IsWidgetDisplayed()) && GameMenu->IsGameMenuVisible();
+}
+
+/*----------------------------------------------------
+    Garbage collection policy
+----------------------------------------------------*/
+
+void FNeutronGarbageCollectionPolicy::StartCommand(ENeutronGarbageCollection NewMode)
+{
+	if (!TransitionActive)
+	{
+		TransitionActive         = true;
+		TransitionCollectionTime = 0;
+		TransitionCollections    = 0;
+	}
+
+	Mode          = NewMode;
+	CommandActive = true;
+
+	if (Mode != ENeutronGarbageCollection::None)
+	{
+		GEngine->ForceGarbageCollection(false);
+	}
+}
+
+void FNeutronGarbageCollectionPolicy::CompleteCommand()
+{
+	if (CommandActive && Mode == ENeutronGarbageCollection::IncrementalAndPurge)
+	{
+		GEngine->ForceGarbageCollection(true);
+	}
+
+	CommandActive = false;
+}
+
+void FNeutronGarbageCollectionPolicy::EndTransition()
+{
+	if (TransitionActive)
+	{
+		NLOG("FNeutronGarbageCollectionPolicy::EndTransition : %d collections for %.2fms", TransitionCollections,
+			TransitionCollectionTime * 1000.0);
+
+		LastTransitionCollectionTime = TransitionCollectionTime;
+		TransitionActive             = false;
+	}
+}
+
+void FNeutronGarbageCollectionPolicy::OnPreGarbageCollect()
+{
+	CollectionStartTime = FPlatformTime::Seconds();
+}
+
+void FNeutronGarbageCollectionPolicy::OnPostGarbageCollect()
+{
+	if (TransitionActive && CollectionStartTime > 0)
+	{
+		TransitionCollectionTime += FPlatformTime::Seconds() - CollectionStartTime;
+		TransitionCollections++;
+	}
+
+	CollectionStartTime = 0;
+}
+
 /*----------------------------------------------------
     Constructor
 ----------------------------------------------------*/
 
 UNeutronMenuManager::UNeutronMenuManager()
 	: Super()
+	, FocusDirty(false)
 	, UsingGamepad(false)
+	, CurrentCommandIdentifier(0)
+	, WorldReady(false)
+	, ReadinessGate(NAME_None)
 	, CurrentMenuState(ENeutronFadeState::FadingFromBlack)
 	, DesiredInterfaceColor(FLinearColor::White)
 	, DesiredHighlightColor(FLinearColor::White)
@@ -34,6 +125,7 @@ UNeutronMenuManager::UNeutronMenuManager()
 	// Settings
 	FadeDuration        = ENeutronUIConstants::FadeDurationLong;
 	ColorChangeDuration = ENeutronUIConstants::FadeDurationShort;
+	ReadinessTimeout    = 10.0f;
 }
 
 /*----------------------------------------------------
@@ -64,28 +156,41 @@ void UNeutronMenuManager::Initialize(UNeutronGameInstance* NewGameInstance)
 
 	Singleton = this;
 	FSlateApplication::Get().SetNavigationConfig(MakeShared<FNeutronNavigationConfig>());
+	FSlateApplication::Get().OnFocusChanging().AddUObject(this, &UNeutronMenuManager::OnFocusChanging);
 	FWorldDelegates::OnWorldCleanup.AddUObject(this, &UNeutronMenuManager::OnWorldCleanup);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UNeutronMenuManager::OnPreGarbageCollect);
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UNeutronMenuManager::OnPostGarbageCollect);
+
+	// Readiness of new levels
+	AddReadinessSource(
+		TEXT("PlayerController"), FNeutronAsyncCondition::CreateUObject(this, &UNeutronMenuManager::IsPlayerControllerReady));
+	AddReadinessSource(
+		TEXT("StreamingLevels"), FNeutronAsyncCondition::CreateUObject(this, &UNeutronMenuManager::AreStreamingLevelsLoaded));
+	AddReadinessSource(TEXT("Assets"), FNeutronAsyncCondition::CreateUObject(this, &UNeutronMenuManager::AreAssetsLoaded));
+	AddReadinessSource(TEXT("Shaders"), FNeutronAsyncCondition::CreateUObject(this, &UNeutronMenuManager::AreShadersCompiled));
 }
 
 void UNeutronMenuManager::Tick(float DeltaTime)
 {
-	if (IsValid(PlayerController) && PlayerController->IsReady() && PlayerController->GetGameTimeSinceCreation() > 2.0f)
+	if (IsValid(PlayerController) && PlayerController->IsReady() && UpdateWorldReadiness())
 	{
 		switch (CurrentMenuState)
 		{
 			// Fade to black, call the provided callback, and move on
 			case ENeutronFadeState::FadingToBlack: {
-				FNeutronAsyncCommand* Command = CommandStack.Peek();
-				if (Command)
+				if (PendingCommands.Num())
 				{
-					FadeDuration = Command->FadeDuration;
+					FadeDuration = PendingCommands[0].FadeDuration;
 				}
 
 				CurrentFadingTime += DeltaTime;
 				CurrentFadingTime = FMath::Clamp(CurrentFadingTime, 0.0f, FadeDuration);
 
-				if (CurrentFadingTime >= FadeDuration && CommandStack.Dequeue(CurrentCommand))
+				// A command still running on the black screen is replaced by the new one
+				if (CurrentFadingTime >= FadeDuration && PendingCommands.Num())
 				{
+					FinishCommand(true);
+					StartNextCommand();
 					CurrentMenuState = ENeutronFadeState::Black;
 				}
 
@@ -116,8 +221,6 @@ void UNeutronMenuManager::Tick(float DeltaTime)
 					CompleteAsyncAction();
 				}
 
-				GEngine->ForceGarbageCollection(true);
-
 				break;
 			}
 
@@ -131,37 +234,25 @@ void UNeutronMenuManager::Tick(float DeltaTime)
 		}
 	}
 
-	// Build focus filter
-	TArray<TSharedPtr<SWidget>> AllowedFocusObjects;
-	AllowedFocusObjects.Add(Menu);
-	AllowedFocusObjects.Add(Overlay);
-
-	// Conditionally allow the game viewport, when not in console
-	UNeutronGameViewportClient* GameViewportClient = Cast<UNeutronGameViewportClient>(GetWorld()->GetGameViewport());
-	if (GameViewportClient && (GameViewportClient->ViewportConsole == nullptr || !GameViewportClient->ViewportConsole->ConsoleActive()))
+	// Reconcile focus after focus events or requests
+	if (FocusDirty)
 	{
-		AllowedFocusObjects.Add(FSlateApplication::Get().GetGameViewport());
-	}
-
-	// Update focus when it's one of our widgets to another of our widgets
-	TSharedPtr<class SWidget> CurrentFocusWidget = FSlateApplication::Get().GetUserFocusedWidget(0);
-	if (DesiredFocusWidget.IsValid() && CurrentFocusWidget != DesiredFocusWidget && AllowedFocusObjects.Contains(CurrentFocusWidget) &&
-		AllowedFocusObjects.Contains(DesiredFocusWidget))
-	{
-		NLOG("UNeutronMenuManager::Tick : moving focus from '%s' to '%s'",
-			CurrentFocusWidget.IsValid() ? *CurrentFocusWidget->GetTypeAsString() : TEXT("null"), *DesiredFocusWidget->GetTypeAsString());
-
-		FSlateApplication::Get().SetAllUserFocus(DesiredFocusWidget.ToSharedRef());
+		UpdateFocus();
 	}
 
 	// Update UI color
 	CurrentInterfaceColor.Set(DesiredInterfaceColor, DeltaTime);
 	CurrentHighlightColor.Set(DesiredHighlightColor, DeltaTime);
 
-	// Update game menus
-	for (INeutronGameMenu* GameMenu : GameMenus)
+	// Update game menus when their data changed, or periodically while they are visible
+	for (FNeutronGameMenuEntry& Entry : GameMenus)
 	{
-		GameMenu->UpdateGameObjects();
+		Entry.TimeSinceUpdate += DeltaTime;
+
+		if (Entry.Dirty || (Entry.IsVisible() && Entry.TimeSinceUpdate >= Entry.GameMenu->GetGameMenuUpdatePeriod()))
+		{
+			UpdateGameMenu(Entry);
+		}
 	}
 }
 
@@ -169,33 +260,123 @@ void UNeutronMenuManager::Tick(float DeltaTime)
     Menu management
 ----------------------------------------------------*/
 
-void UNeutronMenuManager::RunWaitAction(
-	ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action, FNeutronAsyncCondition Condition, bool ShortFade)
+uint32 UNeutronMenuManager::RunCommand(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncCommand Command)
 {
-	NLOG("UNeutronMenuManager::RunWaitAction");
+	Command.Identifier = ++CurrentCommandIdentifier;
+	Command.QueueTime  = FPlatformTime::Seconds();
 
-	Cast<UNeutronGameViewportClient>(GetWorld()->GetGameViewport())->SetLoadingScreen(LoadingScreen);
+	NLOG("UNeutronMenuManager::RunCommand : command %d with priority %d", Command.Identifier, Command.Priority);
+
+	// Drop pending commands superseded by this one
+	if (Command.Key != NAME_None)
+	{
+		int32 DroppedCount = PendingCommands.RemoveAll(
+			[&Command](const FNeutronAsyncCommand& Pending)
+			{
+				return Pending.Key == Command.Key;
+			});
+
+		if (DroppedCount)
+		{
+			NLOG("UNeutronMenuManager::RunCommand : dropped %d superseded '%s' commands", DroppedCount, *Command.Key.ToString());
+		}
+	}
+
+	// Insert after pending commands of equal or higher priority
+	int32 Index = PendingCommands.IndexOfByPredicate(
+		[&Command](const FNeutronAsyncCommand& Pending)
+		{
+			return Pending.Priority < Command.Priority;
+		});
+	PendingCommands.Insert(Command, Index != INDEX_NONE ? Index : PendingCommands.Num());
 
-	CommandStack.Enqueue(FNeutronAsyncCommand(Action, Condition, ShortFade));
+	// Commands scheduled before the screen is black share the same fade
+	Cast<UNeutronGameViewportClient>(GetWorld()->GetGameViewport())->SetLoadingScreen(LoadingScreen);
 	CurrentMenuState = ENeutronFadeState::FadingToBlack;
+
+	return Command.Identifier;
+}
+
+uint32 UNeutronMenuManager::RunWaitAction(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action, FNeutronAsyncCondition Condition,
+	bool ShortFade, ENeutronGarbageCollection GarbageCollection)
+{
+	NLOG("UNeutronMenuManager::RunWaitAction");
+
+	return RunCommand(LoadingScreen, FNeutronAsyncCommand(Action, Condition, ShortFade, GarbageCollection));
 }
 
-void UNeutronMenuManager::RunAction(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action, bool ShortFade)
+uint32 UNeutronMenuManager::RunAction(
+	ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action, bool ShortFade, ENeutronGarbageCollection GarbageCollection)
 {
-	RunWaitAction(LoadingScreen, Action,
+	return RunWaitAction(LoadingScreen, Action,
 		FNeutronAsyncCondition::CreateLambda(
 			[=]()
 			{
 				return false;
 			}),
-		ShortFade);
+		ShortFade, GarbageCollection);
+}
+
+bool UNeutronMenuManager::CancelCommand(uint32 Identifier)
+{
+	// Pending commands are simply removed
+	int32 RemovedCount = PendingCommands.RemoveAll(
+		[Identifier](const FNeutronAsyncCommand& Pending)
+		{
+			return Pending.Identifier == Identifier;
+		});
+
+	if (RemovedCount)
+	{
+		NLOG("UNeutronMenuManager::CancelCommand : cancelled pending command %d", Identifier);
+
+		// Turn around if nothing is left to run
+		if (PendingCommands.Num() == 0 && CurrentMenuState == ENeutronFadeState::FadingToBlack && CurrentCommand.Identifier == 0)
+		{
+			CurrentMenuState = ENeutronFadeState::FadingFromBlack;
+		}
+
+		return true;
+	}
+
+	// The current command stops waiting and completes on the next tick
+	else if (CurrentCommand.Identifier == Identifier && CurrentMenuState == ENeutronFadeState::Black)
+	{
+		NLOG("UNeutronMenuManager::CancelCommand : cancelled current command %d", Identifier);
+
+		CurrentCommand.Action.Unbind();
+		CurrentCommand.Condition.Unbind();
+
+		return true;
+	}
+
+	return false;
+}
+
+void UNeutronMenuManager::AddReadinessSource(FName Name, FNeutronAsyncCondition Condition)
+{
+	RemoveReadinessSource(Name);
+	ReadinessSources.Add(TPair<FName, FNeutronAsyncCondition>(Name, Condition));
+}
+
+void UNeutronMenuManager::RemoveReadinessSource(FName Name)
+{
+	ReadinessSources.RemoveAll(
+		[Name](const TPair<FName, FNeutronAsyncCondition>& Source)
+		{
+			return Source.Key == Name;
+		});
 }
 
 void UNeutronMenuManager::CompleteAsyncAction()
 {
-	if (!CommandStack.Dequeue(CurrentCommand))
+	GarbageCollectionPolicy.CompleteCommand();
+	FinishCommand(false);
+
+	if (!StartNextCommand())
 	{
 		CurrentMenuState = ENeutronFadeState::FadingFromBlack;
+		GarbageCollectionPolicy.EndTransition();
 	}
 }
 
@@ -203,36 +384,52 @@ void UNeutronMenuManager::OpenMenu(FNeutronAsyncAction Action, FNeutronAsyncCond
 {
 	NLOG("UNeutronMenuManager::OpenMenu");
 
-	RunWaitAction(ENeutronLoadingScreen::Black,
-		FNeutronAsyncAction::CreateLambda(
-			[=]()
+	FNeutronAsyncAction MenuAction = FNeutronAsyncAction::CreateLambda(
+		[=]()
+		{
+			if (Menu.IsValid())
 			{
-				if (Menu.IsValid())
-				{
-					Action.ExecuteIfBound();
-					Menu->Show();
-					SetFocusToMenu();
-				}
-			}),
-		Condition);
+				Action.ExecuteIfBound();
+				Menu->Show();
+				SetFocusToMenu();
+			}
+		});
+
+	FNeutronAsyncCommand Command(MenuAction, Condition, false, ENeutronGarbageCollection::Incremental);
+
+	// Plain menu toggles replace each other
+	if (!Action.IsBound() && !Condition.IsBound())
+	{
+		Command.Key = TEXT("Menu");
+	}
+
+	RunCommand(ENeutronLoadingScreen::Black, Command);
 }
 
 void UNeutronMenuManager::CloseMenu(FNeutronAsyncAction Action, FNeutronAsyncCondition Condition)
 {
 	NLOG("UNeutronMenuManager::CloseMenu");
 
-	RunWaitAction(ENeutronLoadingScreen::Black,
-		FNeutronAsyncAction::CreateLambda(
-			[=]()
+	FNeutronAsyncAction MenuAction = FNeutronAsyncAction::CreateLambda(
+		[=]()
+		{
+			if (Menu.IsValid())
 			{
-				if (Menu.IsValid())
-				{
-					Action.ExecuteIfBound();
-					Menu->Hide();
-					SetFocusToGame();
-				}
-			}),
-		Condition);
+				Action.ExecuteIfBound();
+				Menu->Hide();
+				SetFocusToGame();
+			}
+		});
+
+	FNeutronAsyncCommand Command(MenuAction, Condition, false, ENeutronGarbageCollection::Incremental);
+
+	// Plain menu toggles replace each other
+	if (!Action.IsBound() && !Condition.IsBound())
+	{
+		Command.Key = TEXT("Menu");
+	}
+
+	RunCommand(ENeutronLoadingScreen::Black, Command);
 }
 
 bool UNeutronMenuManager::IsMenuOpen() const
@@ -294,6 +491,7 @@ void UNeutronMenuManager::SetFocusToMenu()
 	}
 
 	DesiredFocusWidget = Menu;
+	FocusDirty         = true;
 }
 
 void UNeutronMenuManager::SetFocusToOverlay()
@@ -304,6 +502,7 @@ void UNeutronMenuManager::SetFocusToOverlay()
 	}
 
 	DesiredFocusWidget = Overlay;
+	FocusDirty         = true;
 }
 
 void UNeutronMenuManager::SetFocusToGame()
@@ -311,6 +510,28 @@ void UNeutronMenuManager::SetFocusToGame()
 	GetPC()->SetInputMode(FInputModeGameOnly());
 
 	DesiredFocusWidget = FSlateApplication::Get().GetGameViewport();
+	FocusDirty         = true;
+}
+
+void UNeutronMenuManager::NotifyGameObjectsChanged(FName Dependency)
+{
+	for (FNeutronGameMenuEntry& Entry : GameMenus)
+	{
+		if (Dependency == NAME_None || Entry.Dependencies.Contains(Dependency))
+		{
+			Entry.Dirty = true;
+		}
+	}
+}
+
+void UNeutronMenuManager::DumpGameMenuStatistics() const
+{
+	for (const FNeutronGameMenuEntry& Entry : GameMenus)
+	{
+		NLOG("UNeutronMenuManager::DumpGameMenuStatistics : '%s' %s, %d updates, last %.3fms, average %.3fms",
+			*Entry.GameMenu->GetGameMenuName().ToString(), Entry.IsVisible() ? TEXT("visible") : TEXT("hidden"),
+			Entry.UpdateCount, Entry.LastUpdateTime * 1000.0, Entry.UpdateCount ? Entry.TotalUpdateTime * 1000.0 / Entry.UpdateCount : 0.0);
+	}
 }
 
 void UNeutronMenuManager::SetUsingGamepad(bool State)
@@ -387,6 +608,8 @@ void UNeutronMenuManager::BeginPlayInternal(ANeutronPlayerController* PC, bool A
 	NLOG("UNeutronMenuManager::BeginPlayInternal");
 
 	PlayerController = PC;
+	WorldReady       = false;
+	ReadinessGate    = NAME_None;
 
 	// Assign menus
 	if (AddMenusToScreen)
@@ -445,12 +668,209 @@ void UNeutronMenuManager::BeginPlayInternal(ANeutronPlayerController* PC, bool A
 			}));
 }
 
+void UNeutronMenuManager::UpdateGameMenu(FNeutronGameMenuEntry& Entry)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NeutronGameMenuUpdates);
+
+	double StartTime = FPlatformTime::Seconds();
+	Entry.GameMenu->UpdateGameObjects();
+	Entry.LastUpdateTime = FPlatformTime::Seconds() - StartTime;
+
+	Entry.TotalUpdateTime += Entry.LastUpdateTime;
+	Entry.UpdateCount++;
+	Entry.TimeSinceUpdate = 0;
+	Entry.Dirty           = false;
+}
+
+bool UNeutronMenuManager::IsGameMenuWidgetDisplayed(const SWidget& Widget)
+{
+	if (!Widget.GetVisibility().IsVisible())
+	{
+		return false;
+	}
+
+	// Hidden parents hide the widget too, and so do switchers showing another slot, like tab views
+	const SWidget*      Current = &Widget;
+	TSharedPtr<SWidget> Parent  = Widget.GetParentWidget();
+	while (Parent.IsValid())
+	{
+		if (!Parent->GetVisibility().IsVisible())
+		{
+			return false;
+		}
+		else if (Parent->GetType() == TEXT("SWidgetSwitcher") &&
+				 static_cast<const SWidgetSwitcher*>(Parent.Get())->GetActiveWidget().Get() != Current)
+		{
+			return false;
+		}
+
+		Current = Parent.Get();
+		Parent  = Parent->GetParentWidget();
+	}
+
+	return true;
+}
+
+bool UNeutronMenuManager::IsGameMenuWidgetDisplayed(const SNeutronTabPanel& Panel)
+{
+	return !Panel.IsHidden() && IsGameMenuWidgetDisplayed(static_cast<const SWidget&>(Panel));
+}
+
+void UNeutronMenuManager::OnFocusChanging(const FFocusEvent& FocusEvent, const FWeakWidgetPath& OldFocusedWidgetPath,
+	const TSharedPtr<SWidget>& OldFocusedWidget, const FWidgetPath& NewFocusedWidgetPath, const TSharedPtr<SWidget>& NewFocusedWidget)
+{
+	// Focus is only read after the change, on the next tick
+	FocusDirty = true;
+}
+
+bool UNeutronMenuManager::IsManagedFocusWidget(const TSharedPtr<SWidget>& Widget) const
+{
+	if (!Widget.IsValid())
+	{
+		return false;
+	}
+	else if (Widget == Menu || Widget == Overlay)
+	{
+		return true;
+	}
+
+	// Conditionally allow the game viewport, when not in console
+	else if (Widget == FSlateApplication::Get().GetGameViewport())
+	{
+		UNeutronGameViewportClient* GameViewportClient = Cast<UNeutronGameViewportClient>(GetWorld()->GetGameViewport());
+		return GameViewportClient &&
+			   (GameViewportClient->ViewportConsole == nullptr || !GameViewportClient->ViewportConsole->ConsoleActive());
+	}
+
+	return false;
+}
+
+void UNeutronMenuManager::UpdateFocus()
+{
+	// Update focus when it's one of our widgets to another of our widgets, and check again next time until it succeeds
+	TSharedPtr<SWidget> CurrentFocusWidget = FSlateApplication::Get().GetUserFocusedWidget(0);
+	if (DesiredFocusWidget.IsValid() && CurrentFocusWidget != DesiredFocusWidget && IsManagedFocusWidget(CurrentFocusWidget) &&
+		IsManagedFocusWidget(DesiredFocusWidget))
+	{
+		NLOG("UNeutronMenuManager::UpdateFocus : moving focus from '%s' to '%s'",
+			CurrentFocusWidget.IsValid() ? *CurrentFocusWidget->GetTypeAsString() : TEXT("null"), *DesiredFocusWidget->GetTypeAsString());
+
+		FSlateApplication::Get().SetAllUserFocus(DesiredFocusWidget.ToSharedRef());
+	}
+
+	// Focus is where we want it, or out of our control until the next focus event
+	else
+	{
+		FocusDirty = false;
+	}
+}
+
+bool UNeutronMenuManager::UpdateWorldReadiness()
+{
+	if (!WorldReady)
+	{
+		const float LevelTime = PlayerController->GetGameTimeSinceCreation();
+
+		for (const TPair<FName, FNeutronAsyncCondition>& Source : ReadinessSources)
+		{
+			if (Source.Value.IsBound() && !Source.Value.Execute())
+			{
+				ReadinessGate = Source.Key;
+
+				if (LevelTime < ReadinessTimeout)
+				{
+					return false;
+				}
+
+				NERR("UNeutronMenuManager::UpdateWorldReadiness : timed out waiting for '%s'", *Source.Key.ToString());
+				break;
+			}
+		}
+
+		NLOG("UNeutronMenuManager::UpdateWorldReadiness : ready after %.2fs, last gated by '%s'", LevelTime, *ReadinessGate.ToString());
+		WorldReady = true;
+	}
+
+	return true;
+}
+
+bool UNeutronMenuManager::IsPlayerControllerReady() const
+{
+	return PlayerController->IsReady();
+}
+
+bool UNeutronMenuManager::AreStreamingLevelsLoaded() const
+{
+	for (const ULevelStreaming* Level : PlayerController->GetWorld()->GetStreamingLevels())
+	{
+		if (Level && Level->ShouldBeLoaded() && !Level->IsLevelLoaded())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool UNeutronMenuManager::AreAssetsLoaded() const
+{
+	UNeutronAssetManager* AssetManager = UNeutronAssetManager::Get();
+
+	// Background loads such as music prefetches can't be told apart from other package loads, so only our own loads are waited on then
+	return !AssetManager->IsLoading() && (!IsAsyncLoading() || AssetManager->IsLoadingInBackground());
+}
+
+bool UNeutronMenuManager::AreShadersCompiled() const
+{
+	return GShaderCompilingManager == nullptr || GShaderCompilingManager->GetNumRemainingJobs() == 0;
+}
+
+bool UNeutronMenuManager::StartNextCommand()
+{
+	if (PendingCommands.Num() == 0)
+	{
+		return false;
+	}
+
+	CurrentCommand = PendingCommands[0];
+	PendingCommands.RemoveAt(0);
+	CurrentCommand.StartTime = FPlatformTime::Seconds();
+
+	GarbageCollectionPolicy.StartCommand(CurrentCommand.GarbageCollection);
+
+	return true;
+}
+
+void UNeutronMenuManager::FinishCommand(bool Superseded)
+{
+	if (CurrentCommand.Identifier)
+	{
+		const double CurrentTime = FPlatformTime::Seconds();
+
+		NLOG("UNeutronMenuManager::FinishCommand : command %d %s after %.2fs, %.2fs in queue", CurrentCommand.Identifier,
+			Superseded ? TEXT("superseded") : TEXT("completed"), CurrentTime - CurrentCommand.StartTime,
+			CurrentCommand.StartTime - CurrentCommand.QueueTime);
+
+		CurrentCommand = FNeutronAsyncCommand();
+	}
+}
+
+void UNeutronMenuManager::OnPreGarbageCollect()
+{
+	GarbageCollectionPolicy.OnPreGarbageCollect();
+}
+
+void UNeutronMenuManager::OnPostGarbageCollect()
+{
+	GarbageCollectionPolicy.OnPostGarbageCollect();
+}
+
 void UNeutronMenuManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
 {
 	NLOG("UNeutronMenuManager::OnWorldCleanup");
 
-	for (INeutronGameMenu* GameMenu : GameMenus)
+	for (FNeutronGameMenuEntry& Entry : GameMenus)
 	{
-		GameMenu->UpdateGameObjects();
+		UpdateGameMenu(Entry);
 	}
 }
@@ -23,19 +23,129 @@ enum class ENeutronFadeState : uint8
 	FadingToBlack
 };
 
+/** Garbage collection to run around an async command */
+enum class ENeutronGarbageCollection : uint8
+{
+	None,
+	Incremental,
+	IncrementalAndPurge
+};
+
 /** Async command data */
 struct FNeutronAsyncCommand
 {
-	FNeutronAsyncCommand() : Action(), Condition(), FadeDuration(0)
+	FNeutronAsyncCommand()
+		: Action()
+		, Condition()
+		, FadeDuration(0)
+		, GarbageCollection(ENeutronGarbageCollection::None)
+		, Priority(0)
+		, Key(NAME_None)
+		, Identifier(0)
+		, QueueTime(0)
+		, StartTime(0)
+	{}
+
+	FNeutronAsyncCommand(FNeutronAsyncAction A, FNeutronAsyncCondition C, bool ShortFade, ENeutronGarbageCollection GC)
+		: Action(A)
+		, Condition(C)
+		, FadeDuration(ShortFade ? ENeutronUIConstants::FadeDurationShort : ENeutronUIConstants::FadeDurationLong)
+		, GarbageCollection(GC)
+		, Priority(0)
+		, Key(NAME_None)
+		, Identifier(0)
+		, QueueTime(0)
+		, StartTime(0)
+	{}
+
+	// Command settings
+	FNeutronAsyncAction       Action;
+	FNeutronAsyncCondition    Condition;
+	float                     FadeDuration;
+	ENeutronGarbageCollection GarbageCollection;
+
+	// Scheduling settings : higher priorities run first, a new command replaces pending ones with the same key
+	int32 Priority;
+	FName Key;
+
+	// Scheduler state
+	uint32 Identifier;
+	double QueueTime;
+	double StartTime;
+};
+
+/** Registered game menu with its update state */
+struct FNeutronGameMenuEntry
+{
+	FNeutronGameMenuEntry() : GameMenu(nullptr), Dirty(true), TimeSinceUpdate(0), UpdateCount(0), LastUpdateTime(0), TotalUpdateTime(0)
 	{}
 
-	FNeutronAsyncCommand(FNeutronAsyncAction A, FNeutronAsyncCondition C, bool ShortFade)
-		: Action(A), Condition(C), FadeDuration(ShortFade ? ENeutronUIConstants::FadeDurationShort : ENeutronUIConstants::FadeDurationLong)
+	FNeutronGameMenuEntry(class INeutronGameMenu* Menu, const TArray<FName>& MenuDependencies)
+		: GameMenu(Menu)
+		, Dependencies(MenuDependencies)
+		, Dirty(true)
+		, TimeSinceUpdate(0)
+		, UpdateCount(0)
+		, LastUpdateTime(0)
+		, TotalUpdateTime(0)
+	{}
+
+	/** Check if the menu is displayed, for widget menus that is also the state of the widget */
+	bool IsVisible() const;
+
+	// Menu settings
+	class INeutronGameMenu* GameMenu;
+	TArray<FName>           Dependencies;
+	TFunction<bool()>       IsWidgetDisplayed;
+
+	// Update state
+	bool  Dirty;
+	float TimeSinceUpdate;
+
+	// Statistics
+	int32  UpdateCount;
+	double LastUpdateTime;
+	double TotalUpdateTime;
+};
+
+/** Garbage collection policy for transitions, collecting once per command instead of on every black frame */
+struct FNeutronGarbageCollectionPolicy
+{
+	FNeutronGarbageCollectionPolicy()
+		: Mode(ENeutronGarbageCollection::None)
+		, CommandActive(false)
+		, TransitionActive(false)
+		, CollectionStartTime(0)
+		, TransitionCollectionTime(0)
+		, TransitionCollections(0)
+		, LastTransitionCollectionTime(0)
 	{}
 
-	FNeutronAsyncAction    Action;
-	FNeutronAsyncCondition Condition;
-	float                  FadeDuration;
+	/** A command is starting on a black screen, request an incremental collection if needed */
+	void StartCommand(ENeutronGarbageCollection NewMode);
+
+	/** The command has completed, request a full purge if needed */
+	void CompleteCommand();
+
+	/** The screen is fading back from black, report collection time */
+	void EndTransition();
+
+	/** A collection is starting */
+	void OnPreGarbageCollect();
+
+	/** A collection has ended */
+	void OnPostGarbageCollect();
+
+	// Current state
+	ENeutronGarbageCollection Mode;
+	bool                      CommandActive;
+	bool                      TransitionActive;
+
+	// Statistics
+	double CollectionStartTime;
+	double TransitionCollectionTime;
+	int32  TransitionCollections;
+	double LastTransitionCollectionTime;
 };
 
 /*----------------------------------------------------
@@ -111,16 +221,30 @@ public:
 	    Menu management
 	----------------------------------------------------*/
 
+	/** Schedule a command with a loading screen, return its identifier */
+	uint32 RunCommand(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncCommand Command);
+
 	/** Fade to black with a loading screen, call the action, wait for the condition to return true, then fade back */
-	void RunWaitAction(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action,
-		FNeutronAsyncCondition Condition = FNeutronAsyncCondition(), bool ShortFade = false);
+	uint32 RunWaitAction(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action,
+		FNeutronAsyncCondition Condition = FNeutronAsyncCondition(), bool ShortFade = false,
+		ENeutronGarbageCollection GarbageCollection = ENeutronGarbageCollection::Incremental);
 
 	/** Fade to black with a loading screen, call the action, stay black */
-	void RunAction(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action, bool ShortFade = false);
+	uint32 RunAction(ENeutronLoadingScreen LoadingScreen, FNeutronAsyncAction Action, bool ShortFade = false,
+		ENeutronGarbageCollection GarbageCollection = ENeutronGarbageCollection::Incremental);
+
+	/** Cancel a pending command, or stop waiting for the condition of the current one */
+	bool CancelCommand(uint32 Identifier);
 
 	/** Manually reveal the game image once the action is finished */
 	void CompleteAsyncAction();
 
+	/** Get the time spent collecting garbage during the last transition, in seconds */
+	double GetLastTransitionCollectionTime() const
+	{
+		return GarbageCollectionPolicy.LastTransitionCollectionTime;
+	}
+
 	/** Check if the menu system is idle */
 	bool IsIdle() const
 	{
@@ -161,12 +285,36 @@ public:
 	    Menu tools
 	----------------------------------------------------*/
 
-	/** Register a menu **/
-	void RegisterGameMenu(TSharedPtr<class INeutronGameMenu> GameMenu)
+	/** Register a menu, updated when its dependencies change, and periodically while visible **/
+	template <typename T>
+	void RegisterGameMenu(TSharedPtr<T> GameMenu, const TArray<FName>& Dependencies = TArray<FName>())
 	{
-		GameMenus.Add(GameMenu.Get());
+		FNeutronGameMenuEntry& Entry = GameMenus.Add_GetRef(FNeutronGameMenuEntry(GameMenu.Get(), Dependencies));
+
+		// Widget menus are hidden while collapsed or faded out
+		if constexpr (TIsDerivedFrom<T, SWidget>::Value)
+		{
+			TWeakPtr<T> WeakMenu    = GameMenu;
+			Entry.IsWidgetDisplayed = [WeakMenu]()
+			{
+				TSharedPtr<T> Menu = WeakMenu.Pin();
+				return Menu.IsValid() && IsGameMenuWidgetDisplayed(*Menu);
+			};
+		}
+	}
+
+	/** Signal that game data has changed, updating menus that depend on it, or all menus with NAME_None */
+	void NotifyGameObjectsChanged(FName Dependency = NAME_None);
+
+	/** Get the registered game menus with their update statistics */
+	const TArray<FNeutronGameMenuEntry>& GetGameMenus() const
+	{
+		return GameMenus;
 	}
 
+	/** Write the game menu update statistics to the log */
+	void DumpGameMenuStatistics() const;
+
 	/** Get the local player controller owning the menus */
 	template <typename T = ANeutronPlayerController>
 	T* GetPC() const
@@ -188,6 +336,18 @@ public:
 		return StaticCastSharedPtr<T>(Overlay);
 	}
 
+	/** Register a condition that must be true on a new level before transitions run */
+	void AddReadinessSource(FName Name, FNeutronAsyncCondition Condition);
+
+	/** Remove a readiness condition */
+	void RemoveReadinessSource(FName Name);
+
+	/** Check if all readiness conditions have been met on the current level */
+	bool IsWorldReady() const
+	{
+		return WorldReady;
+	}
+
 	/** Set the focus to the main menu */
 	void SetFocusToMenu();
 
@@ -226,6 +386,52 @@ protected:
 	/** World was cleaned up, warn menus */
 	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
 
+	/** Update a game menu and record its cost */
+	void UpdateGameMenu(FNeutronGameMenuEntry& Entry);
+
+	/** Check if a widget game menu is displayed, along with all its parents */
+	static bool IsGameMenuWidgetDisplayed(const SWidget& Widget);
+
+	/** Check if a tab panel game menu is displayed */
+	static bool IsGameMenuWidgetDisplayed(const class SNeutronTabPanel& Panel);
+
+	/** Slate focus is about to change */
+	void OnFocusChanging(const FFocusEvent& FocusEvent, const FWeakWidgetPath& OldFocusedWidgetPath,
+		const TSharedPtr<SWidget>& OldFocusedWidget, const FWidgetPath& NewFocusedWidgetPath, const TSharedPtr<SWidget>& NewFocusedWidget);
+
+	/** Check if a widget is one that focus can be moved away from and to */
+	bool IsManagedFocusWidget(const TSharedPtr<SWidget>& Widget) const;
+
+	/** Move the focus to the desired widget if needed */
+	void UpdateFocus();
+
+	/** Check the readiness conditions until all are met or the timeout is reached */
+	bool UpdateWorldReadiness();
+
+	/** Check if the player controller is set up */
+	bool IsPlayerControllerReady() const;
+
+	/** Check if all streaming levels that should be loaded are */
+	bool AreStreamingLevelsLoaded() const;
+
+	/** Check if asynchronous asset loads are complete */
+	bool AreAssetsLoaded() const;
+
+	/** Check if shader compilation is complete */
+	bool AreShadersCompiled() const;
+
+	/** Start processing the next pending command on a black screen, return false if there is none */
+	bool StartNextCommand();
+
+	/** Report the current command as finished */
+	void FinishCommand(bool Superseded);
+
+	/** A garbage collection is starting */
+	void OnPreGarbageCollect();
+
+	/** A garbage collection has ended */
+	void OnPostGarbageCollect();
+
 	/*----------------------------------------------------
 	    Properties
 	----------------------------------------------------*/
@@ -240,6 +446,10 @@ public:
 	UPROPERTY(Category = Neutron, EditDefaultsOnly)
 	float ColorChangeDuration;
 
+	// Time in seconds after which a new level is considered ready even if readiness conditions are not met
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float ReadinessTimeout;
+
 protected:
 
 	/*----------------------------------------------------
@@ -257,13 +467,23 @@ protected:
 	TSharedPtr<class SNeutronMenu> Menu;
 	TSharedPtr<class SWidget>      Overlay;
 	TSharedPtr<class SWidget>      DesiredFocusWidget;
+	bool                           FocusDirty;
 
 	// Current menu state
 	bool                            UsingGamepad;
 	FNeutronAsyncCommand            CurrentCommand;
-	TQueue<FNeutronAsyncCommand>    CommandStack;
+	TArray<FNeutronAsyncCommand>    PendingCommands;
+	uint32                          CurrentCommandIdentifier;
 	ENeutronFadeState               CurrentMenuState;
-	TArray<class INeutronGameMenu*> GameMenus;
+	TArray<FNeutronGameMenuEntry>   GameMenus;
+
+	// Level readiness
+	TArray<TPair<FName, FNeutronAsyncCondition>> ReadinessSources;
+	bool                                         WorldReady;
+	FName                                        ReadinessGate;
+
+	// Garbage collection state
+	FNeutronGarbageCollectionPolicy GarbageCollectionPolicy;
 
 	// Current color state
 	float                              CurrentFadingTime;
@@ -0,0 +1,218 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronNetworkProfiler.h"
+#include "NeutronGameInstance.h"
+
+#include "Neutron/Neutron.h"
+
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Statics
+UNeutronNetworkProfiler* UNeutronNetworkProfiler::Singleton = nullptr;
+
+// Console interface
+static FAutoConsoleCommand NeutronNetProfileCommand(TEXT("neutron.NetProfile"),
+	TEXT("Replication profiling for Neutron classes : start, stop, reset, dump, csv"),    //
+	FConsoleCommandWithArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args)
+		{
+			UNeutronNetworkProfiler* Profiler = UNeutronNetworkProfiler::Get();
+			if (Profiler == nullptr)
+			{
+				return;
+			}
+
+			FString Command = Args.Num() ? Args[0] : TEXT("dump");
+			if (Command == TEXT("start"))
+			{
+				Profiler->SetEnabled(true);
+			}
+			else if (Command == TEXT("stop"))
+			{
+				Profiler->SetEnabled(false);
+			}
+			else if (Command == TEXT("reset"))
+			{
+				Profiler->Reset();
+			}
+			else if (Command == TEXT("csv"))
+			{
+				NLOG("UNeutronNetworkProfiler : exported to '%s'", *Profiler->ExportCSV());
+			}
+			else
+			{
+				Profiler->Dump();
+			}
+		}));
+
+/*----------------------------------------------------
+    Constructor
+----------------------------------------------------*/
+
+UNeutronNetworkProfiler::UNeutronNetworkProfiler() : Super(), GameInstance(nullptr), Enabled(false), CurrentWindowTime(0)
+{}
+
+/*----------------------------------------------------
+    System interface
+----------------------------------------------------*/
+
+void UNeutronNetworkProfiler::Initialize(UNeutronGameInstance* Instance)
+{
+	Singleton    = this;
+	GameInstance = Instance;
+}
+
+void UNeutronNetworkProfiler::SetEnabled(bool NewEnabled)
+{
+	NLOG("UNeutronNetworkProfiler::SetEnabled %d", NewEnabled);
+
+	// Don't lose the partial window when stopping, or carry it over when restarting
+	RollWindow();
+
+	Enabled = NewEnabled;
+}
+
+void UNeutronNetworkProfiler::Reset()
+{
+	ClassReplication.Empty();
+	ClassRPCs.Empty();
+	RPCs.Empty();
+	CurrentWindowTime = 0;
+}
+
+/*----------------------------------------------------
+    Recording
+----------------------------------------------------*/
+
+void UNeutronNetworkProfiler::RecordRPC(const UObject* Object, const UFunction* Function)
+{
+	if (Enabled)
+	{
+		// Parameter size is the uncompressed payload, before serialization and packet overhead
+		const uint64 Bytes = Function->ParmsSize;
+
+		FNeutronNetworkProfilerEntry& ClassEntry = ClassRPCs.FindOrAdd(Object->GetClass()->GetFName());
+		ClassEntry.WindowCount++;
+		ClassEntry.WindowBytes += Bytes;
+
+		FNeutronNetworkProfilerEntry& FunctionEntry = RPCs.FindOrAdd(Function->GetFName());
+		FunctionEntry.WindowCount++;
+		FunctionEntry.WindowBytes += Bytes;
+	}
+}
+
+void UNeutronNetworkProfiler::RecordReplication(const AActor* Actor)
+{
+	if (Enabled)
+	{
+		FNeutronNetworkProfilerEntry& Entry = ClassReplication.FindOrAdd(Actor->GetClass()->GetFName());
+		Entry.WindowCount++;
+	}
+}
+
+/*----------------------------------------------------
+    Reporting
+----------------------------------------------------*/
+
+void UNeutronNetworkProfiler::Dump() const
+{
+	UNetDriver* NetDriver = GameInstance->GetWorld() ? GameInstance->GetWorld()->GetNetDriver() : nullptr;
+	if (NetDriver)
+	{
+		NLOG("UNeutronNetworkProfiler::Dump : total %d B/s in, %d B/s out", NetDriver->InBytesPerSecond, NetDriver->OutBytesPerSecond);
+	}
+
+	auto DumpEntries = [](const TCHAR* Category, const TMap<FName, FNeutronNetworkProfilerEntry>& Entries)
+	{
+		for (const TPair<FName, FNeutronNetworkProfilerEntry>& Entry : Entries)
+		{
+			NLOG("UNeutronNetworkProfiler::Dump : %s '%s' : %llu calls, %llu B, %.1f calls/s, %.1f B/s", Category, *Entry.Key.ToString(),
+				Entry.Value.GetTotalCount(), Entry.Value.GetTotalBytes(), Entry.Value.CountPerSecond, Entry.Value.BytesPerSecond);
+		}
+	};
+
+	DumpEntries(TEXT("replication"), ClassReplication);
+	DumpEntries(TEXT("class RPC"), ClassRPCs);
+	DumpEntries(TEXT("RPC"), RPCs);
+}
+
+FString UNeutronNetworkProfiler::ExportCSV() const
+{
+	FString Report = TEXT("Category,Name,Count,Bytes,CountPerSecond,BytesPerSecond\n");
+
+	auto ExportEntries = [&Report](const TCHAR* Category, const TMap<FName, FNeutronNetworkProfilerEntry>& Entries)
+	{
+		for (const TPair<FName, FNeutronNetworkProfilerEntry>& Entry : Entries)
+		{
+			Report += FString::Printf(TEXT("%s,%s,%llu,%llu,%f,%f\n"), Category, *Entry.Key.ToString(), Entry.Value.GetTotalCount(),
+				Entry.Value.GetTotalBytes(), Entry.Value.CountPerSecond, Entry.Value.BytesPerSecond);
+		}
+	};
+
+	ExportEntries(TEXT("Replication"), ClassReplication);
+	ExportEntries(TEXT("ClassRPC"), ClassRPCs);
+	ExportEntries(TEXT("RPC"), RPCs);
+
+	FString Path = FString::Printf(
+		TEXT("%s/NeutronNetProfile-%s.csv"), *FPaths::ProfilingDir(), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")));
+	FFileHelper::SaveStringToFile(Report, *Path);
+
+	return Path;
+}
+
+/*----------------------------------------------------
+    Tick
+----------------------------------------------------*/
+
+void UNeutronNetworkProfiler::Tick(float DeltaTime)
+{
+	if (!Enabled)
+	{
+		return;
+	}
+
+	// Roll the per-second rates once per window
+	CurrentWindowTime += DeltaTime;
+	if (CurrentWindowTime >= 1.0f)
+	{
+		RollWindow();
+	}
+}
+
+/*----------------------------------------------------
+    Internals
+----------------------------------------------------*/
+
+void UNeutronNetworkProfiler::RollWindow()
+{
+	auto RollEntries = [this](TMap<FName, FNeutronNetworkProfilerEntry>& Entries)
+	{
+		for (TPair<FName, FNeutronNetworkProfilerEntry>& Entry : Entries)
+		{
+			FNeutronNetworkProfilerEntry& Value = Entry.Value;
+
+			// Rates are only meaningful over a window that actually elapsed
+			if (CurrentWindowTime > 0)
+			{
+				Value.CountPerSecond = Value.WindowCount / CurrentWindowTime;
+				Value.BytesPerSecond = Value.WindowBytes / CurrentWindowTime;
+			}
+
+			Value.Count += Value.WindowCount;
+			Value.Bytes += Value.WindowBytes;
+			Value.WindowCount = 0;
+			Value.WindowBytes = 0;
+		}
+	};
+
+	RollEntries(ClassReplication);
+	RollEntries(ClassRPCs);
+	RollEntries(RPCs);
+
+	CurrentWindowTime = 0;
+}
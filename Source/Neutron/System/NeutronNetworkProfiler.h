@@ -0,0 +1,153 @@
+// Neutron - Gwennaël Arbona
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+
+#include "NeutronNetworkProfiler.generated.h"
+
+/*----------------------------------------------------
+    Supporting types
+----------------------------------------------------*/
+
+/** Replication statistics for a class or RPC */
+struct FNeutronNetworkProfilerEntry
+{
+	FNeutronNetworkProfilerEntry() : Count(0), Bytes(0), WindowCount(0), WindowBytes(0), CountPerSecond(0), BytesPerSecond(0)
+	{}
+
+	/** Get the call count including the window being recorded */
+	uint64 GetTotalCount() const
+	{
+		return Count + WindowCount;
+	}
+
+	/** Get the byte count including the window being recorded */
+	uint64 GetTotalBytes() const
+	{
+		return Bytes + WindowBytes;
+	}
+
+	uint64 Count;
+	uint64 Bytes;
+	uint64 WindowCount;
+	uint64 WindowBytes;
+	float  CountPerSecond;
+	float  BytesPerSecond;
+};
+
+/*----------------------------------------------------
+    Network profiler
+----------------------------------------------------*/
+
+/** Replication instrumentation for Neutron classes, controlled with the neutron.NetProfile console command */
+UCLASS(ClassGroup = (Neutron))
+class NEUTRON_API UNeutronNetworkProfiler
+	: public UObject
+	, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UNeutronNetworkProfiler();
+
+	/*----------------------------------------------------
+	    System interface
+	----------------------------------------------------*/
+
+	/** Get the singleton instance */
+	static UNeutronNetworkProfiler* Get()
+	{
+		return Singleton;
+	}
+
+	/** Initialize this class */
+	void Initialize(class UNeutronGameInstance* Instance);
+
+	/** Start or stop recording */
+	void SetEnabled(bool Enabled);
+
+	/** Check if recording is ongoing */
+	bool IsEnabled() const
+	{
+		return Enabled;
+	}
+
+	/** Forget all recorded data */
+	void Reset();
+
+	/*----------------------------------------------------
+	    Recording
+	----------------------------------------------------*/
+
+	/** Record an outgoing RPC with its parameter payload */
+	void RecordRPC(const UObject* Object, const class UFunction* Function);
+
+	/** Record an actor being considered for property replication */
+	void RecordReplication(const class AActor* Actor);
+
+	/*----------------------------------------------------
+	    Reporting
+	----------------------------------------------------*/
+
+	/** Write the current statistics to the log */
+	void Dump() const;
+
+	/** Write the current statistics to a CSV file in the profiling folder, return its path */
+	FString ExportCSV() const;
+
+	/*----------------------------------------------------
+	    Tick
+	----------------------------------------------------*/
+
+	virtual void              Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override
+	{
+		return ETickableTickType::Always;
+	}
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UNeutronNetworkProfiler, STATGROUP_Tickables);
+	}
+	virtual bool IsTickableWhenPaused() const
+	{
+		return true;
+	}
+	virtual bool IsTickableInEditor() const
+	{
+		return false;
+	}
+
+	/*----------------------------------------------------
+	    Internals
+	----------------------------------------------------*/
+
+protected:
+
+	/** Fold the current window into the totals and rates */
+	void RollWindow();
+
+	/*----------------------------------------------------
+	    Data
+	----------------------------------------------------*/
+
+protected:
+
+	// Singleton pointer
+	static UNeutronNetworkProfiler* Singleton;
+
+	// Game instance pointer
+	UPROPERTY()
+	class UNeutronGameInstance* GameInstance;
+
+	// State
+	bool  Enabled;
+	float CurrentWindowTime;
+
+	// Statistics
+	TMap<FName, FNeutronNetworkProfilerEntry> ClassReplication;
+	TMap<FName, FNeutronNetworkProfilerEntry> ClassRPCs;
+	TMap<FName, FNeutronNetworkProfilerEntry> RPCs;
+};
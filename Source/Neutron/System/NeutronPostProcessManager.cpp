@@ -17,12 +17,24 @@
 // Statics
 UNeutronPostProcessManager* UNeutronPostProcessManager::Singleton = nullptr;
 
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Post-process update"), STAT_NeutronPostProcessUpdate, STATGROUP_Tickables);
+
 /*----------------------------------------------------
     Constructor
 ----------------------------------------------------*/
 
-UNeutronPostProcessManager::UNeutronPostProcessManager() : Super(), CurrentPreset(0), TargetPreset(0), CurrentPresetAlpha(0.0f)
-{}
+UNeutronPostProcessManager::UNeutronPostProcessManager()
+	: Super()
+	, BlendValueCount(0)
+	, TargetPreset(0)
+	, BlendApplied(false)
+	, AppliedCinematicBloom(false)
+	, AppliedLumen(false)
+	, UserSettingsApplied(false)
+{
+	EasingTable.Initialize(ENeutronUIConstants::EaseStandard);
+}
 
 /*----------------------------------------------------
     Gameplay
@@ -34,39 +46,60 @@ void UNeutronPostProcessManager::Initialize(UNeutronGameInstance* GameInstance)
 }
 
 void UNeutronPostProcessManager::BeginPlay(
-	ANeutronPlayerController* PC, FNeutronPostProcessControl Control, FNeutronPostProcessUpdate Update)
+	ANeutronPlayerController* PC, FNeutronPostProcessControl Control, FNeutronPostProcessUpdate Update, FNeutronPostProcessBlend Blend)
 {
 	ControlFunction = Control;
 	UpdateFunction  = Update;
+	BlendFunction   = Blend;
 
-	TArray<AActor*> PostProcessActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ANeutronPostProcessActor::StaticClass(), PostProcessActors);
-
-	// Set the post process
-	if (PostProcessActors.Num())
+	// Set the post process, left to SetPostProcessComponent when running without a world
+	if (GetWorld())
 	{
-		PostProcessVolume = Cast<UPostProcessComponent>(PostProcessActors[0]->GetComponentByClass(UPostProcessComponent::StaticClass()));
+		TArray<AActor*> PostProcessActors;
+		UGameplayStatics::GetAllActorsOfClass(GetWorld(), ANeutronPostProcessActor::StaticClass(), PostProcessActors);
 
-		// Replace the material by a dynamic variant
-		if (PostProcessVolume)
+		if (PostProcessActors.Num())
 		{
-			TArray<FWeightedBlendable> Blendables = PostProcessVolume->Settings.WeightedBlendables.Array;
-			PostProcessVolume->Settings.WeightedBlendables.Array.Empty();
-			PostProcessMaterials.Empty();
+			SetPostProcessComponent(
+				Cast<UPostProcessComponent>(PostProcessActors[0]->GetComponentByClass(UPostProcessComponent::StaticClass())));
+		}
+	}
+}
 
-			for (FWeightedBlendable Blendable : Blendables)
-			{
-				UMaterialInterface* BaseMaterial = Cast<UMaterialInterface>(Blendable.Object);
-				NCHECK(BaseMaterial);
+void UNeutronPostProcessManager::SetPostProcessComponent(UPostProcessComponent* Component)
+{
+	PostProcessVolume = Component;
 
-				UMaterialInstanceDynamic* MaterialInstance = UMaterialInstanceDynamic::Create(BaseMaterial, GetWorld());
-				PostProcessMaterials.Add(MaterialInstance);
+	// The volume is new, force a full update on the next tick
+	BlendApplied        = false;
+	UserSettingsApplied = false;
 
-				PostProcessVolume->Settings.AddBlendable(MaterialInstance, 1.0f);
-			}
+	// Replace the material by a dynamic variant
+	if (PostProcessVolume)
+	{
+		TArray<FWeightedBlendable> Blendables = PostProcessVolume->Settings.WeightedBlendables.Array;
+		PostProcessVolume->Settings.WeightedBlendables.Array.Empty();
+		PostProcessMaterials.Empty();
+
+		// Parameter indices are specific to each material set
+		ScalarParameters.Empty();
+		VectorParameters.Empty();
+		ScalarParameterIndices.Empty();
+		VectorParameterIndices.Empty();
+
+		for (const FWeightedBlendable& Blendable : Blendables)
+		{
+			UMaterialInterface* BaseMaterial = Cast<UMaterialInterface>(Blendable.Object);
+			NCHECK(BaseMaterial);
+
+			UMaterialInstanceDynamic* MaterialInstance = AcquireMaterial(BaseMaterial);
+			PostProcessMaterials.Add(MaterialInstance);
 
-			NLOG("UNeutronPostProcessManager::BeginPlay : post-process setup complete");
+			PostProcessVolume->Settings.AddBlendable(MaterialInstance, 1.0f);
 		}
+
+		NLOG("UNeutronPostProcessManager::SetPostProcessComponent : post-process setup complete with %d materials, %d pooled",
+			PostProcessMaterials.Num(), MaterialPool.Num());
 	}
 }
 
@@ -76,47 +109,250 @@ void UNeutronPostProcessManager::BeginPlay(
 
 void UNeutronPostProcessManager::Tick(float DeltaTime)
 {
-	if (IsValid(PostProcessVolume))
+	SCOPE_CYCLE_COUNTER(STAT_NeutronPostProcessUpdate);
+
+	if (IsValid(PostProcessVolume) && TargetPresetSettings.IsValid())
+	{
+		// Update desired settings, retargeting from the current blend
+		if (ControlFunction.IsBound())
+		{
+			int32 NewTargetPreset = ControlFunction.Execute();
+			if (NewTargetPreset != TargetPreset)
+			{
+				SetTargetPreset(NewTargetPreset);
+			}
+		}
+
+		// Apply the new settings only while a transition is running
+		if (UpdateLayers(DeltaTime) || !BlendApplied)
+		{
+			BlendLayers();
+			BlendApplied = true;
+		}
+
+		FlushMaterialParameters();
+
+		ApplyUserSettings();
+	}
+}
+
+/*----------------------------------------------------
+    Internals
+----------------------------------------------------*/
+
+void UNeutronPostProcessManager::AddPreset(int32 Index, TSharedPtr<FNeutronPostProcessSettingBase> Preset)
+{
+	NCHECK(Preset.IsValid());
+
+	// Snapshot the values once, all presets need to provide the same amount
+	Preset->BlendValues.Reset();
+	Preset->GetBlendValues(Preset->BlendValues);
+	if (Preset->BlendValues.Num())
+	{
+		NCHECK(BlendValueCount == 0 || BlendValueCount == Preset->BlendValues.Num());
+		BlendValueCount = Preset->BlendValues.Num();
+	}
+
+	PostProcessSettings.Add(Index, Preset);
+
+	// Refresh the cached presets
+	NeutralPresetSettings = PostProcessSettings.FindRef(0);
+	if (Index == TargetPreset)
+	{
+		TargetPresetSettings = Preset;
+		if (Layers.Num() == 0)
+		{
+			Layers.Add(FNeutronPostProcessLayer(Index, Preset, 1.0f));
+		}
+	}
+	for (FNeutronPostProcessLayer& Layer : Layers)
+	{
+		if (Layer.Preset == Index)
+		{
+			Layer.Settings = Preset;
+		}
+	}
+
+	BlendApplied = false;
+}
+
+void UNeutronPostProcessManager::SetTargetPreset(int32 Index)
+{
+	TargetPreset         = Index;
+	TargetPresetSettings = PostProcessSettings.FindRef(Index);
+	NCHECK(TargetPresetSettings.IsValid());
+
+	// Reuse the layer if the preset is still fading out, so that the transition resumes from its current alpha
+	for (const FNeutronPostProcessLayer& Layer : Layers)
+	{
+		if (Layer.Preset == Index)
+		{
+			return;
+		}
+	}
+
+	Layers.Add(FNeutronPostProcessLayer(Index, TargetPresetSettings, 0.0f));
+}
+
+bool UNeutronPostProcessManager::UpdateLayers(float DeltaTime)
+{
+	// The target fades in while all other presets fade out at the same rate
+	const float Step    = DeltaTime / TargetPresetSettings->TransitionDuration;
+	bool        Changed = false;
+
+	for (int32 Index = Layers.Num() - 1; Index >= 0; Index--)
+	{
+		FNeutronPostProcessLayer& Layer    = Layers[Index];
+		const bool                IsTarget = Layer.Preset == TargetPreset;
+
+		const float NewAlpha = FMath::Clamp(Layer.Alpha + (IsTarget ? Step : -Step), 0.0f, 1.0f);
+		if (NewAlpha != Layer.Alpha)
+		{
+			Layer.Alpha = NewAlpha;
+			Changed     = true;
+		}
+
+		if (!IsTarget && Layer.Alpha <= 0)
+		{
+			Layers.RemoveAt(Index);
+			Changed = true;
+		}
+	}
+
+	return Changed;
+}
+
+void UNeutronPostProcessManager::BlendLayers()
+{
+	// Compute the eased, normalized weights
+	float TotalWeight = 0;
+	for (FNeutronPostProcessLayer& Layer : Layers)
+	{
+		Layer.Weight = EasingTable.Evaluate(Layer.Alpha);
+		TotalWeight += Layer.Weight;
+	}
+	if (TotalWeight > KINDA_SMALL_NUMBER)
 	{
-		// Update desired settings
-		if (ControlFunction.IsBound() && CurrentPreset == TargetPreset)
+		for (FNeutronPostProcessLayer& Layer : Layers)
 		{
-			TargetPreset = ControlFunction.Execute();
+			Layer.Weight /= TotalWeight;
+		}
+	}
+
+	// Blend the preset snapshots
+	BlendedValues.Reset(BlendValueCount);
+	BlendedValues.SetNumZeroed(BlendValueCount);
+	for (const FNeutronPostProcessLayer& Layer : Layers)
+	{
+		const TArray<float>& Values = Layer.Settings->BlendValues;
+		if (Values.Num() == BlendValueCount)
+		{
+			for (int32 ValueIndex = 0; ValueIndex < BlendValueCount; ValueIndex++)
+			{
+				BlendedValues[ValueIndex] += Layer.Weight * Values[ValueIndex];
+			}
+		}
+	}
+
+	BlendFunction.ExecuteIfBound(PostProcessVolume, PostProcessMaterials, BlendedValues);
+
+	// Presets without snapshots are blended by the update function, from the strongest fading preset to the target
+	if (UpdateFunction.IsBound())
+	{
+		const FNeutronPostProcessLayer* TargetLayer   = nullptr;
+		const FNeutronPostProcessLayer* PreviousLayer = nullptr;
+		for (const FNeutronPostProcessLayer& Layer : Layers)
+		{
+			if (Layer.Preset == TargetPreset)
+			{
+				TargetLayer = &Layer;
+			}
+			else if (PreviousLayer == nullptr || Layer.Weight > PreviousLayer->Weight)
+			{
+				PreviousLayer = &Layer;
+			}
 		}
 
-		// Update transition time
-		float CurrentTransitionDuration = PostProcessSettings[TargetPreset]->TransitionDuration;
-		if (CurrentPreset != TargetPreset)
+		// Without a fading preset, the target is blended in from the neutral preset
+		UpdateFunction.Execute(PostProcessVolume, PostProcessMaterials, PreviousLayer ? PreviousLayer->Settings : NeutralPresetSettings,
+			TargetLayer ? TargetLayer->Settings : TargetPresetSettings, TargetLayer ? TargetLayer->Weight : 0.0f);
+	}
+}
+
+UMaterialInstanceDynamic* UNeutronPostProcessManager::AcquireMaterial(UMaterialInterface* BaseMaterial)
+{
+	// Look for an instance of the same material that isn't already used by this level
+	for (UMaterialInstanceDynamic* Material : MaterialPool)
+	{
+		if (Material->Parent == BaseMaterial && !PostProcessMaterials.Contains(Material))
 		{
-			CurrentPresetAlpha -= DeltaTime / CurrentTransitionDuration;
+			Material->ClearParameterValues();
+			return Material;
 		}
-		else if (CurrentPreset != 0)
+	}
+
+	// Materials are owned by the manager so that they outlive the world
+	UMaterialInstanceDynamic* Material = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+	MaterialPool.Add(Material);
+
+	return Material;
+}
+
+void UNeutronPostProcessManager::FlushMaterialParameters()
+{
+	for (FNeutronMaterialParameter<float>& Parameter : ScalarParameters)
+	{
+		if (Parameter.Dirty)
 		{
-			CurrentPresetAlpha += DeltaTime / CurrentTransitionDuration;
+			UMaterialInstanceDynamic* Material = PostProcessMaterials[Parameter.MaterialIndex];
+			if (Parameter.ParameterIndex == INDEX_NONE || !Material->SetScalarParameterByIndex(Parameter.ParameterIndex, Parameter.Value))
+			{
+				Material->InitializeScalarParameterAndGetIndex(Parameter.Name, Parameter.Value, Parameter.ParameterIndex);
+			}
+			Parameter.Dirty = false;
 		}
-		CurrentPresetAlpha = FMath::Clamp(CurrentPresetAlpha, 0.0f, 1.0f);
+	}
 
-		// Manage state transitions
-		if (CurrentPresetAlpha <= 0)
+	for (FNeutronMaterialParameter<FLinearColor>& Parameter : VectorParameters)
+	{
+		if (Parameter.Dirty)
 		{
-			CurrentPreset = TargetPreset;
+			UMaterialInstanceDynamic* Material = PostProcessMaterials[Parameter.MaterialIndex];
+			if (Parameter.ParameterIndex == INDEX_NONE || !Material->SetVectorParameterByIndex(Parameter.ParameterIndex, Parameter.Value))
+			{
+				Material->InitializeVectorParameterAndGetIndex(Parameter.Name, Parameter.Value, Parameter.ParameterIndex);
+			}
+			Parameter.Dirty = false;
 		}
+	}
+}
 
-		// Get post process targets and apply the new settings
-		float InterpolatedAlpha = FMath::InterpEaseInOut(0.0f, 1.0f, CurrentPresetAlpha, ENeutronUIConstants::EaseStandard);
-		TSharedPtr<FNeutronPostProcessSettingBase>& CurrentPostProcess = PostProcessSettings[0];
-		TSharedPtr<FNeutronPostProcessSettingBase>& TargetPostProcess  = PostProcessSettings[CurrentPreset];
-		UpdateFunction.ExecuteIfBound(PostProcessVolume, PostProcessMaterials, CurrentPostProcess, TargetPostProcess, CurrentPresetAlpha);
-
-		// Apply config-driven settings
-		UNeutronGameUserSettings* GameUserSettings        = Cast<UNeutronGameUserSettings>(GEngine->GetGameUserSettings());
-		PostProcessVolume->Settings.bOverride_BloomMethod = true;
-		PostProcessVolume->Settings.bOverride_DynamicGlobalIlluminationMethod = true;
-		PostProcessVolume->Settings.bOverride_ReflectionMethod                = true;
-		PostProcessVolume->Settings.BloomMethod                               = GameUserSettings->EnableCinematicBloom ? BM_FFT : BM_SOG;
-		PostProcessVolume->Settings.DynamicGlobalIlluminationMethod =
+void UNeutronPostProcessManager::ApplyUserSettings()
+{
+	const UNeutronGameUserSettings* GameUserSettings = Cast<UNeutronGameUserSettings>(GEngine->GetGameUserSettings());
+
+	// Games without Neutron settings keep the rendering methods of the volume
+	if (GameUserSettings == nullptr)
+	{
+		return;
+	}
+
+	// Writing the volume settings invalidates the render state, only do it on changes
+	if (!UserSettingsApplied || GameUserSettings->EnableCinematicBloom != AppliedCinematicBloom ||
+		GameUserSettings->EnableLumen != AppliedLumen)
+	{
+		FPostProcessSettings& Settings = PostProcessVolume->Settings;
+
+		Settings.bOverride_BloomMethod                     = true;
+		Settings.bOverride_DynamicGlobalIlluminationMethod = true;
+		Settings.bOverride_ReflectionMethod                = true;
+		Settings.BloomMethod                               = GameUserSettings->EnableCinematicBloom ? BM_FFT : BM_SOG;
+		Settings.DynamicGlobalIlluminationMethod =
 			GameUserSettings->EnableLumen ? EDynamicGlobalIlluminationMethod::Lumen : EDynamicGlobalIlluminationMethod::ScreenSpace;
-		PostProcessVolume->Settings.ReflectionMethod =
-			GameUserSettings->EnableLumen ? EReflectionMethod::Lumen : EReflectionMethod::ScreenSpace;
+		Settings.ReflectionMethod = GameUserSettings->EnableLumen ? EReflectionMethod::Lumen : EReflectionMethod::ScreenSpace;
+
+		AppliedCinematicBloom = GameUserSettings->EnableCinematicBloom;
+		AppliedLumen          = GameUserSettings->EnableLumen;
+		UserSettingsApplied   = true;
 	}
 }
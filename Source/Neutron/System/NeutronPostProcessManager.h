@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Tickable.h"
 #include "GameFramework/Actor.h"
+#include "Neutron/Neutron.h"
 
 #include "NeutronPostProcessManager.generated.h"
 
@@ -18,14 +19,87 @@ struct FNeutronPostProcessSettingBase
 	FNeutronPostProcessSettingBase() : TransitionDuration(0.5f)
 	{}
 
-	float TransitionDuration;
+	virtual ~FNeutronPostProcessSettingBase()
+	{}
+
+	/** Write the numeric values to blend, in an order shared by all presets - called once on registration */
+	virtual void GetBlendValues(TArray<float>& Values) const
+	{}
+
+	float         TransitionDuration;
+	TArray<float> BlendValues;
+};
+
+// Preset being blended, with its linear transition alpha and its final eased, normalized weight
+struct FNeutronPostProcessLayer
+{
+	FNeutronPostProcessLayer() : Preset(0), Alpha(0), Weight(0)
+	{}
+
+	FNeutronPostProcessLayer(int32 NewPreset, const TSharedPtr<FNeutronPostProcessSettingBase>& NewSettings, float NewAlpha)
+		: Preset(NewPreset), Settings(NewSettings), Alpha(NewAlpha), Weight(0)
+	{}
+
+	int32                                      Preset;
+	TSharedPtr<FNeutronPostProcessSettingBase> Settings;
+	float                                      Alpha;
+	float                                      Weight;
+};
+
+/** Ease-in-out curve sampled once, to avoid evaluating the power function per layer and per frame */
+struct FNeutronEasingTable
+{
+	FNeutronEasingTable() : Samples{}
+	{}
+
+	/** Sample the curve for an ease exponent */
+	void Initialize(float Exponent)
+	{
+		for (int32 Index = 0; Index <= Resolution; Index++)
+		{
+			Samples[Index] = FMath::InterpEaseInOut(0.0f, 1.0f, static_cast<float>(Index) / Resolution, Exponent);
+		}
+	}
+
+	/** Get the eased value for a linear alpha in [0, 1] */
+	float Evaluate(float Alpha) const
+	{
+		const float Position = FMath::Clamp(Alpha, 0.0f, 1.0f) * Resolution;
+		const int32 Index    = FMath::Min(FMath::FloorToInt(Position), Resolution - 1);
+
+		return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - Index);
+	}
+
+	static constexpr int32 Resolution = 64;
+	float                  Samples[Resolution + 1];
+};
+
+// Material parameter write, batched until the end of the tick and skipped when the value didn't change
+template <typename T>
+struct FNeutronMaterialParameter
+{
+	FNeutronMaterialParameter(int32 NewMaterialIndex, FName NewName, const T& NewValue)
+		: MaterialIndex(NewMaterialIndex), Name(NewName), ParameterIndex(INDEX_NONE), Value(NewValue), Dirty(true)
+	{}
+
+	int32 MaterialIndex;
+	FName Name;
+	int32 ParameterIndex;
+	T     Value;
+	bool  Dirty;
 };
 
 // Control function to determine the post-processing index
 DECLARE_DELEGATE_RetVal(int32, FNeutronPostProcessControl);
+
+// Update function receiving the strongest fading preset, the target preset and the target's blend weight
 DECLARE_DELEGATE_FiveParams(FNeutronPostProcessUpdate, class UPostProcessComponent*, TArray<class UMaterialInstanceDynamic*>,
 	const TSharedPtr<FNeutronPostProcessSettingBase>&, const TSharedPtr<FNeutronPostProcessSettingBase>&, float);
 
+// Update function receiving the blend of all active presets' values
+DECLARE_DELEGATE_ThreeParams(
+	FNeutronPostProcessBlend, class UPostProcessComponent*, const TArray<class UMaterialInstanceDynamic*>&, const TArray<float>&);
+
 /** Post-processing owner */
 UCLASS(ClassGroup = (Neutron))
 class NEUTRON_API ANeutronPostProcessActor : public AActor
@@ -63,7 +137,11 @@ public:
 	void Initialize(class UNeutronGameInstance* GameInstance);
 
 	/** Start playing on a new level */
-	void BeginPlay(class ANeutronPlayerController* PC, FNeutronPostProcessControl Control, FNeutronPostProcessUpdate Update);
+	void BeginPlay(class ANeutronPlayerController* PC, FNeutronPostProcessControl Control, FNeutronPostProcessUpdate Update,
+		FNeutronPostProcessBlend Blend = FNeutronPostProcessBlend());
+
+	/** Take control of a post-process component, replacing its materials with dynamic instances */
+	void SetPostProcessComponent(class UPostProcessComponent* Component);
 
 	/*----------------------------------------------------
 	    Public methods
@@ -73,7 +151,37 @@ public:
 	template <typename T>
 	void RegisterPreset(T Index, TSharedPtr<FNeutronPostProcessSettingBase> Preset)
 	{
-		PostProcessSettings.Add(static_cast<int32>(Index), Preset);
+		AddPreset(static_cast<int32>(Index), Preset);
+	}
+
+	/** Set a scalar parameter on a post-process material, applied at the end of the tick if it changed */
+	void SetScalarParameter(int32 MaterialIndex, FName Name, float Value)
+	{
+		SetMaterialParameter(ScalarParameters, ScalarParameterIndices, MaterialIndex, Name, Value);
+	}
+
+	/** Set a vector parameter on a post-process material, applied at the end of the tick if it changed */
+	void SetVectorParameter(int32 MaterialIndex, FName Name, const FLinearColor& Value)
+	{
+		SetMaterialParameter(VectorParameters, VectorParameterIndices, MaterialIndex, Name, Value);
+	}
+
+	/** Get the presets currently being blended */
+	const TArray<FNeutronPostProcessLayer, TInlineAllocator<4>>& GetLayers() const
+	{
+		return Layers;
+	}
+
+	/** Get the post-process component being controlled */
+	const class UPostProcessComponent* GetPostProcessComponent() const
+	{
+		return PostProcessVolume;
+	}
+
+	/** Get the current blend of all preset values */
+	const TArray<float>& GetBlendedValues() const
+	{
+		return BlendedValues;
 	}
 
 	/*----------------------------------------------------
@@ -87,7 +195,7 @@ public:
 	}
 	virtual TStatId GetStatId() const override
 	{
-		RETURN_QUICK_DECLARE_CYCLE_STAT(UNeutronSoundManager, STATGROUP_Tickables);
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UNeutronPostProcessManager, STATGROUP_Tickables);
 	}
 	virtual bool IsTickableWhenPaused() const
 	{
@@ -98,6 +206,56 @@ public:
 		return false;
 	}
 
+	/*----------------------------------------------------
+	    Internals
+	----------------------------------------------------*/
+
+protected:
+
+	/** Register a new preset and take the snapshot of its values */
+	void AddPreset(int32 Index, TSharedPtr<FNeutronPostProcessSettingBase> Preset);
+
+	/** Start blending toward a new preset from the current blended state */
+	void SetTargetPreset(int32 Index);
+
+	/** Advance the layer alphas, return true if any of them changed */
+	bool UpdateLayers(float DeltaTime);
+
+	/** Compute the layer weights and blended values, and run the update functions */
+	void BlendLayers();
+
+	/** Get a dynamic instance of a post-process material, reusing one from a previous level if possible */
+	class UMaterialInstanceDynamic* AcquireMaterial(class UMaterialInterface* BaseMaterial);
+
+	/** Record a parameter write for the next flush */
+	template <typename T>
+	void SetMaterialParameter(TArray<FNeutronMaterialParameter<T>>& Parameters, TMap<TPair<int32, FName>, int32>& Indices,
+		int32 MaterialIndex, FName Name, const T& Value)
+	{
+		NCHECK(PostProcessMaterials.IsValidIndex(MaterialIndex));
+
+		const int32* Index = Indices.Find(TPair<int32, FName>(MaterialIndex, Name));
+		if (Index)
+		{
+			FNeutronMaterialParameter<T>& Parameter = Parameters[*Index];
+			if (Parameter.Value != Value)
+			{
+				Parameter.Value = Value;
+				Parameter.Dirty = true;
+			}
+		}
+		else
+		{
+			Indices.Add(TPair<int32, FName>(MaterialIndex, Name), Parameters.Add(FNeutronMaterialParameter<T>(MaterialIndex, Name, Value)));
+		}
+	}
+
+	/** Apply all modified material parameters */
+	void FlushMaterialParameters();
+
+	/** Write the config-driven settings to the post-process volume when they changed since the last call */
+	void ApplyUserSettings();
+
 protected:
 
 	/*----------------------------------------------------
@@ -111,6 +269,10 @@ protected:
 	UPROPERTY()
 	TArray<class UMaterialInstanceDynamic*> PostProcessMaterials;
 
+	// Dynamic materials created so far, reused across levels
+	UPROPERTY()
+	TArray<class UMaterialInstanceDynamic*> MaterialPool;
+
 	// Post-process component that's dynamically controlled
 	UPROPERTY()
 	class UPostProcessComponent* PostProcessVolume;
@@ -118,8 +280,29 @@ protected:
 	// General state
 	FNeutronPostProcessControl                              ControlFunction;
 	FNeutronPostProcessUpdate                               UpdateFunction;
-	int32                                                   CurrentPreset;
-	int32                                                   TargetPreset;
-	float                                                   CurrentPresetAlpha;
+	FNeutronPostProcessBlend                                BlendFunction;
 	TMap<int32, TSharedPtr<FNeutronPostProcessSettingBase>> PostProcessSettings;
+	int32                                                   BlendValueCount;
+
+	// Blending state
+	int32                                                 TargetPreset;
+	TSharedPtr<FNeutronPostProcessSettingBase>            NeutralPresetSettings;
+	TSharedPtr<FNeutronPostProcessSettingBase>            TargetPresetSettings;
+	TArray<FNeutronPostProcessLayer, TInlineAllocator<4>> Layers;
+	TArray<float>                                         BlendedValues;
+	FNeutronEasingTable                                   EasingTable;
+
+	// Batched material parameters
+	TArray<FNeutronMaterialParameter<float>>        ScalarParameters;
+	TArray<FNeutronMaterialParameter<FLinearColor>> VectorParameters;
+	TMap<TPair<int32, FName>, int32>                ScalarParameterIndices;
+	TMap<TPair<int32, FName>, int32>                VectorParameterIndices;
+
+	// Set once the current blend was sent to the update functions, cleared when a transition runs
+	bool BlendApplied;
+
+	// Last config-driven settings written to the volume
+	bool AppliedCinematicBloom;
+	bool AppliedLumen;
+	bool UserSettingsApplied;
 };
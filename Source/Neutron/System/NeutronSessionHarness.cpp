@@ -0,0 +1,379 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronSessionHarness.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "NeutronGameInstance.h"
+#include "NeutronMenuManager.h"
+#include "NeutronSessionsManager.h"
+
+#include "Neutron/Player/NeutronPlayerController.h"
+#include "Neutron/Neutron.h"
+
+#include "GameFramework/GameStateBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Engine/World.h"
+
+/*----------------------------------------------------
+    Constructor
+----------------------------------------------------*/
+
+FNeutronSessionHarness::FNeutronSessionHarness()
+	: GameInstance(nullptr)
+	, Role(ENeutronSessionHarnessRole::Host)
+	, ClientCount(1)
+	, IterationCount(1)
+	, StepTimeout(60.0f)
+	, CurrentStep(0)
+	, CurrentIteration(0)
+	, StepStartTime(0)
+	, StepStarted(false)
+	, Finished(false)
+	, SearchComplete(false)
+	, TransitionComplete(false)
+	, TransitionGeneration(0)
+	, JoinTransitionGeneration(0)
+	, WasInSharedTransition(false)
+{}
+
+/*----------------------------------------------------
+    System interface
+----------------------------------------------------*/
+
+bool FNeutronSessionHarness::IsRequested()
+{
+	FString RoleName;
+	return FParse::Value(FCommandLine::Get(), TEXT("NeutronSessionHarness="), RoleName);
+}
+
+void FNeutronSessionHarness::Initialize(UNeutronGameInstance* Instance)
+{
+	GameInstance = Instance;
+
+	// Read parameters
+	FString RoleName;
+	FParse::Value(FCommandLine::Get(), TEXT("NeutronSessionHarness="), RoleName);
+	FParse::Value(FCommandLine::Get(), TEXT("HarnessClients="), ClientCount);
+	FParse::Value(FCommandLine::Get(), TEXT("HarnessIterations="), IterationCount);
+	FParse::Value(FCommandLine::Get(), TEXT("HarnessTimeout="), StepTimeout);
+	Role = RoleName == TEXT("Client") ? ENeutronSessionHarnessRole::Client : ENeutronSessionHarnessRole::Host;
+
+	NLOG("FNeutronSessionHarness::Initialize : running as %s with %d clients, %d iterations", *RoleName, ClientCount, IterationCount);
+
+	// Build the script
+	if (Role == ENeutronSessionHarnessRole::Host)
+	{
+		AddHostSteps();
+		LaunchClients();
+	}
+	else
+	{
+		AddClientSteps();
+	}
+	Statistics.SetNum(Steps.Num());
+}
+
+/*----------------------------------------------------
+    Tick
+----------------------------------------------------*/
+
+void FNeutronSessionHarness::Tick(float DeltaTime)
+{
+	if (Finished || Steps.Num() == 0)
+	{
+		return;
+	}
+
+	const double                      CurrentTime = FPlatformTime::Seconds();
+	const FNeutronSessionHarnessStep& Step        = Steps[CurrentStep];
+
+	// Count shared transitions as they start, since steps may only start once one is over
+	ANeutronPlayerController* PC                 = GetPlayerController();
+	const bool                InSharedTransition = PC && PC->IsInSharedTransition();
+	if (InSharedTransition && !WasInSharedTransition)
+	{
+		TransitionGeneration++;
+	}
+	WasInSharedTransition = InSharedTransition;
+
+	// Wait for the player to be in control before starting a step
+	if (!StepStarted)
+	{
+		if (PC && UNeutronMenuManager::Get()->IsIdle())
+		{
+			NLOG("FNeutronSessionHarness::Tick : iteration %d, starting '%s'", CurrentIteration, *Step.Name);
+
+			StepStarted   = true;
+			StepStartTime = CurrentTime;
+			Statistics[CurrentStep].Runs++;
+
+			if (Step.Start)
+			{
+				Step.Start();
+			}
+		}
+
+		return;
+	}
+
+	// Process the current step
+	const double ElapsedTime = CurrentTime - StepStartTime;
+	if (Step.IsComplete())
+	{
+		NLOG("FNeutronSessionHarness::Tick : '%s' done in %.2fs", *Step.Name, ElapsedTime);
+
+		FNeutronSessionHarnessStepStatistics& StepStatistics = Statistics[CurrentStep];
+		StepStatistics.TotalTime += ElapsedTime;
+		StepStatistics.MinTime = FMath::Min(StepStatistics.MinTime, ElapsedTime);
+		StepStatistics.MaxTime = FMath::Max(StepStatistics.MaxTime, ElapsedTime);
+
+		StartNextStep();
+	}
+
+	// Retry the step's action while waiting
+	else if (Step.ShouldRestart && Step.ShouldRestart())
+	{
+		NLOG("FNeutronSessionHarness::Tick : restarting '%s'", *Step.Name);
+
+		Step.Start();
+	}
+
+	// A failed step leaves the session in an unknown state, so abort the run
+	else if (ElapsedTime > StepTimeout)
+	{
+		NERR("FNeutronSessionHarness::Tick : '%s' timed out after %.2fs", *Step.Name, ElapsedTime);
+
+		Statistics[CurrentStep].Failures++;
+		Finish();
+	}
+}
+
+/*----------------------------------------------------
+    Internals
+----------------------------------------------------*/
+
+void FNeutronSessionHarness::AddHostSteps()
+{
+	Steps.Add({TEXT("Create"),
+		[=]()
+		{
+			GetPlayerController()->SetGameOnline(true, ClientCount + 1);
+		},
+		[=]()
+		{
+			return UNeutronSessionsManager::Get()->IsOnline() && GameInstance->GetWorld()->GetNetMode() == NM_ListenServer &&
+			       GetPlayerController();
+		}});
+
+	Steps.Add({TEXT("WaitForClients"), nullptr,
+		[=]()
+		{
+			return GetPlayerCount() >= ClientCount + 1;
+		}});
+
+	Steps.Add({TEXT("SharedTransition"),
+		[=]()
+		{
+			ANeutronPlayerController* PC = GetPlayerController();
+
+			TransitionComplete = false;
+			PC->SharedTransition(PC->GetCameraState<uint8>(), FNeutronAsyncAction(), FNeutronAsyncCondition(),
+				FNeutronAsyncAction::CreateLambda(
+					[=]()
+					{
+						TransitionComplete = true;
+					}));
+		},
+		[=]()
+		{
+			return TransitionComplete && !GetPlayerController()->IsInSharedTransition();
+		}});
+
+	Steps.Add({TEXT("WaitForClientsToLeave"), nullptr,
+		[=]()
+		{
+			return GetPlayerCount() <= 1;
+		}});
+
+	Steps.Add({TEXT("End"),
+		[=]()
+		{
+			GetPlayerController()->SetGameOnline(false);
+		},
+		[=]()
+		{
+			return !UNeutronSessionsManager::Get()->IsOnline() && GameInstance->GetWorld()->GetNetMode() == NM_Standalone &&
+			       GetPlayerController();
+		}});
+}
+
+void FNeutronSessionHarness::AddClientSteps()
+{
+	Steps.Add({TEXT("Search"),
+		[=]()
+		{
+			UNeutronSessionsManager* SessionsManager = UNeutronSessionsManager::Get();
+
+			SearchComplete = false;
+			SearchResults.Empty();
+
+			FNeutronOnSessionSearchComplete Callback = FNeutronOnSessionSearchComplete::CreateLambda(
+				[=](TArray<FOnlineSessionSearchResult> Results)
+				{
+					SearchResults  = Results;
+					SearchComplete = true;
+				});
+
+			SessionsManager->InvalidateSearchCache();
+			SessionsManager->SearchSessions(true, Callback);
+		},
+		[=]()
+		{
+			return SearchResults.Num() > 0;
+		},
+		[=]()
+		{
+			// Keep searching until the host shows up
+			return SearchComplete && SearchResults.Num() == 0 && !UNeutronSessionsManager::Get()->IsBusy();
+		}});
+
+	Steps.Add({TEXT("Join"),
+		[=]()
+		{
+			JoinTransitionGeneration = TransitionGeneration;
+			UNeutronSessionsManager::Get()->JoinSearchResult(SearchResults[0]);
+		},
+		[=]()
+		{
+			return GameInstance->GetWorld()->GetNetMode() == NM_Client && GetPlayerController();
+		}});
+
+	Steps.Add({TEXT("SharedTransition"), nullptr,
+		[=]()
+		{
+			ANeutronPlayerController* PC = GetPlayerController();
+
+			return TransitionGeneration != JoinTransitionGeneration && PC && !PC->IsInSharedTransition();
+		}});
+
+	Steps.Add({TEXT("Leave"),
+		[=]()
+		{
+			GetPlayerController()->SetGameOnline(false);
+		},
+		[=]()
+		{
+			return !UNeutronSessionsManager::Get()->IsOnline() && GameInstance->GetWorld()->GetNetMode() == NM_Standalone &&
+			       GetPlayerController();
+		}});
+}
+
+void FNeutronSessionHarness::LaunchClients()
+{
+	if (UNeutronSessionsManager::Get()->GetOnlineSubsystemName() != TEXT("Null"))
+	{
+		NERR("FNeutronSessionHarness::LaunchClients : the harness is meant to run with the Null online subsystem");
+	}
+
+	FString Parameters = FString::Printf(TEXT("-NeutronSessionHarness=Client -HarnessIterations=%d -HarnessTimeout=%f "
+											  "-ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null -nullrhi -nosound -unattended"),
+		IterationCount, StepTimeout);
+
+#if WITH_EDITOR
+	Parameters = FString::Printf(TEXT("\"%s\" -game %s"), *FPaths::GetProjectFilePath(), *Parameters);
+#endif
+
+	for (int32 Index = 0; Index < ClientCount; Index++)
+	{
+		FString ClientParameters = FString::Printf(TEXT("%s -log=SessionHarnessClient%d.log"), *Parameters, Index);
+
+		NLOG("FNeutronSessionHarness::LaunchClients : %s", *ClientParameters);
+
+		FProcHandle Process = FPlatformProcess::CreateProc(
+			FPlatformProcess::ExecutablePath(), *ClientParameters, true, true, true, nullptr, 0, nullptr, nullptr);
+		if (Process.IsValid())
+		{
+			ClientProcesses.Add(Process);
+		}
+		else
+		{
+			NERR("FNeutronSessionHarness::LaunchClients : failed to start client %d", Index);
+		}
+	}
+}
+
+void FNeutronSessionHarness::StartNextStep()
+{
+	StepStarted = false;
+	CurrentStep++;
+
+	if (CurrentStep >= Steps.Num())
+	{
+		CurrentStep = 0;
+		CurrentIteration++;
+
+		if (CurrentIteration >= IterationCount)
+		{
+			Finish();
+		}
+	}
+}
+
+void FNeutronSessionHarness::Finish()
+{
+	Finished = true;
+
+	// Report
+	bool    HasFailures = false;
+	FString Report      = TEXT("Step,Runs,Failures,AverageTime,MinTime,MaxTime\n");
+	for (int32 Index = 0; Index < Steps.Num(); Index++)
+	{
+		const FNeutronSessionHarnessStepStatistics& StepStatistics = Statistics[Index];
+
+		const double MinTime = StepStatistics.Runs > StepStatistics.Failures ? StepStatistics.MinTime : 0;
+
+		NLOG("FNeutronSessionHarness::Finish : '%s' : %d runs, %d failures, %.2fs average, %.2fs min, %.2fs max", *Steps[Index].Name,
+			StepStatistics.Runs, StepStatistics.Failures, StepStatistics.GetAverageTime(), MinTime, StepStatistics.MaxTime);
+
+		Report += FString::Printf(TEXT("%s,%d,%d,%f,%f,%f\n"), *Steps[Index].Name, StepStatistics.Runs, StepStatistics.Failures,
+			StepStatistics.GetAverageTime(), MinTime, StepStatistics.MaxTime);
+
+		HasFailures |= StepStatistics.Failures > 0;
+	}
+
+	FString ReportPath = FString::Printf(TEXT("%s/SessionHarness/%s-%d.csv"), *FPaths::ProjectSavedDir(),
+		Role == ENeutronSessionHarnessRole::Host ? TEXT("Host") : TEXT("Client"), FPlatformProcess::GetCurrentProcessId());
+	FFileHelper::SaveStringToFile(Report, *ReportPath);
+
+	// Don't leave clients behind
+	for (FProcHandle& Process : ClientProcesses)
+	{
+		if (HasFailures && FPlatformProcess::IsProcRunning(Process))
+		{
+			FPlatformProcess::TerminateProc(Process);
+		}
+		FPlatformProcess::CloseProc(Process);
+	}
+	ClientProcesses.Empty();
+
+	FPlatformMisc::RequestExitWithStatus(false, HasFailures ? 1 : 0);
+}
+
+ANeutronPlayerController* FNeutronSessionHarness::GetPlayerController() const
+{
+	ANeutronPlayerController* PC = Cast<ANeutronPlayerController>(GameInstance->GetFirstLocalPlayerController());
+
+	return PC && PC->HasActorBegunPlay() ? PC : nullptr;
+}
+
+int32 FNeutronSessionHarness::GetPlayerCount() const
+{
+	AGameStateBase* GameState = GameInstance->GetWorld() ? GameInstance->GetWorld()->GetGameState() : nullptr;
+
+	return GameState ? GameState->PlayerArray.Num() : 0;
+}
+
+#endif    // !UE_BUILD_SHIPPING
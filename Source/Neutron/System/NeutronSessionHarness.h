@@ -0,0 +1,158 @@
+// Neutron - Gwennaël Arbona
+
+#pragma once
+
+#if !UE_BUILD_SHIPPING
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "OnlineSessionSettings.h"
+
+/*----------------------------------------------------
+    Supporting types
+----------------------------------------------------*/
+
+/** Harness role for this process */
+enum class ENeutronSessionHarnessRole : uint8
+{
+	Host,
+	Client
+};
+
+/** Scripted step of the session flow, started again while ShouldRestart is true */
+struct FNeutronSessionHarnessStep
+{
+	FString           Name;
+	TFunction<void()> Start;
+	TFunction<bool()> IsComplete;
+	TFunction<bool()> ShouldRestart;
+};
+
+/** Timing and failure statistics for a step */
+struct FNeutronSessionHarnessStepStatistics
+{
+	FNeutronSessionHarnessStepStatistics() : Runs(0), Failures(0), TotalTime(0), MinTime(MAX_dbl), MaxTime(0)
+	{}
+
+	double GetAverageTime() const
+	{
+		int32 Successes = Runs - Failures;
+		return Successes > 0 ? TotalTime / Successes : 0;
+	}
+
+	int32  Runs;
+	int32  Failures;
+	double TotalTime;
+	double MinTime;
+	double MaxTime;
+};
+
+/*----------------------------------------------------
+    Session harness
+----------------------------------------------------*/
+
+/** Automated session flow driver, running a listen host and local clients through create, search, join, transition and leave.
+    Enabled with -NeutronSessionHarness=Host on a single process, which then launches -HarnessClients=N headless clients.
+    Development tool, not available in shipping builds. */
+class NEUTRON_API FNeutronSessionHarness : public FTickableGameObject
+{
+public:
+
+	FNeutronSessionHarness();
+
+	/*----------------------------------------------------
+	    System interface
+	----------------------------------------------------*/
+
+	/** Check the command line for harness parameters */
+	static bool IsRequested();
+
+	/** Initialize this class */
+	void Initialize(class UNeutronGameInstance* Instance);
+
+	/*----------------------------------------------------
+	    Tick
+	----------------------------------------------------*/
+
+	virtual void              Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override
+	{
+		return ETickableTickType::Always;
+	}
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FNeutronSessionHarness, STATGROUP_Tickables);
+	}
+	virtual bool IsTickableWhenPaused() const
+	{
+		return true;
+	}
+	virtual bool IsTickableInEditor() const
+	{
+		return false;
+	}
+
+protected:
+
+	/*----------------------------------------------------
+	    Internals
+	----------------------------------------------------*/
+
+	/** Build the host script */
+	void AddHostSteps();
+
+	/** Build the client script */
+	void AddClientSteps();
+
+	/** Start the clients processes */
+	void LaunchClients();
+
+	/** Move to the next step, or the next iteration */
+	void StartNextStep();
+
+	/** Log the results, write them to disk and exit */
+	void Finish();
+
+	/** Get the local player controller when it's ready to be driven */
+	class ANeutronPlayerController* GetPlayerController() const;
+
+	/** Get the number of players in the current world */
+	int32 GetPlayerCount() const;
+
+	/*----------------------------------------------------
+	    Data
+	----------------------------------------------------*/
+
+protected:
+
+	// Game instance pointer, owning this harness
+	class UNeutronGameInstance* GameInstance;
+
+	// Settings
+	ENeutronSessionHarnessRole Role;
+	int32                      ClientCount;
+	int32                      IterationCount;
+	float                      StepTimeout;
+
+	// Script
+	TArray<FNeutronSessionHarnessStep>           Steps;
+	TArray<FNeutronSessionHarnessStepStatistics> Statistics;
+	int32                                        CurrentStep;
+	int32                                        CurrentIteration;
+	double                                       StepStartTime;
+	bool                                         StepStarted;
+	bool                                         Finished;
+
+	// Step state
+	TArray<FOnlineSessionSearchResult> SearchResults;
+	bool                               SearchComplete;
+	bool                               TransitionComplete;
+	TArray<FProcHandle>                ClientProcesses;
+
+	// Shared transitions seen on this process, tracked regardless of the current step
+	uint32 TransitionGeneration;
+	uint32 JoinTransitionGeneration;
+	bool   WasInSharedTransition;
+};
+
+#endif    // !UE_BUILD_SHIPPING
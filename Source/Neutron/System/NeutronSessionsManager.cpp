@@ -3,6 +3,7 @@
 #include "NeutronSessionsManager.h"
 
 #include "NeutronGameInstance.h"
+#include "NeutronMenuManager.h"
 
 #include "Neutron/UI/NeutronUI.h"
 #include "Neutron/Neutron.h"
@@ -12,6 +13,8 @@
 #include "Engine/World.h"
 #include "Engine.h"
 
+#include "Icmp.h"
+
 #define LOCTEXT_NAMESPACE "UNeutronSessionsManager"
 
 // Statics
@@ -21,8 +24,37 @@ UNeutronSessionsManager* UNeutronSessionsManager::Singleton = nullptr;
     Constructor
 ----------------------------------------------------*/
 
-UNeutronSessionsManager::UNeutronSessionsManager() : Super(), NetworkState(ENeutronNetworkState::Offline)
+UNeutronSessionsManager::UNeutronSessionsManager()
+	: Super()
+	, NetworkState(ENeutronNetworkState::Offline)
+	, StateStartTime(0)
+	, RetryCount(0)
+	, RetryTime(0)
+	, IsRetrying(false)
+	, FindingFriendSession(false)
+	, JoinStartTime(0)
+	, LatencyProbeGeneration(0)
+	, PendingLatencyProbes(0)
+	, FriendsCacheTime(0)
+	, FriendsRefreshing(false)
 {
+	// Settings
+	StartTimeout   = 15.0f;
+	SearchTimeout  = 10.0f;
+	JoinTimeout    = 15.0f;
+	DestroyTimeout = 10.0f;
+	MaxRetries     = 2;
+	RetryDelay     = 1.0f;
+
+	// Friends settings
+	FriendsCacheDuration = 120.0f;
+
+	// Session ranking settings
+	ProbeSessionLatency  = true;
+	LatencyProbeTimeout  = 1.0f;
+	SessionLatencyWeight = 1.0f;
+	SessionLoadWeight    = 50.0f;
+
 	// Session callbacks
 	OnCreateSessionCompleteDelegate =
 		FOnCreateSessionCompleteDelegate::CreateUObject(this, &UNeutronSessionsManager::OnCreateSessionComplete);
@@ -39,6 +71,8 @@ UNeutronSessionsManager::UNeutronSessionsManager() : Super(), NetworkState(ENeut
 		FOnSessionUserInviteAcceptedDelegate::CreateUObject(this, &UNeutronSessionsManager::OnSessionUserInviteAccepted);
 	OnFindFriendSessionCompleteDelegate =
 		FOnFindFriendSessionCompleteDelegate::CreateUObject(this, &UNeutronSessionsManager::OnFindFriendSessionComplete);
+	OnPresenceReceivedDelegate = FOnPresenceReceivedDelegate::CreateUObject(this, &UNeutronSessionsManager::OnPresenceReceived);
+	OnFriendsChangeDelegate    = FOnFriendsChangeDelegate::CreateUObject(this, &UNeutronSessionsManager::OnFriendsChange);
 }
 
 /*----------------------------------------------------
@@ -60,6 +94,20 @@ void UNeutronSessionsManager::Initialize(UNeutronGameInstance* Instance)
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		OnSessionUserInviteAcceptedDelegateHandle =
 			Sessions->AddOnSessionUserInviteAcceptedDelegate_Handle(OnSessionUserInviteAcceptedDelegate);
+
+		// Setup friends presence updates
+		IOnlinePresencePtr Presence = OnlineSub->GetPresenceInterface();
+		if (Presence.IsValid())
+		{
+			OnPresenceReceivedDelegateHandle = Presence->AddOnPresenceReceivedDelegate_Handle(OnPresenceReceivedDelegate);
+		}
+
+		// Setup friends list updates
+		IOnlineFriendsPtr FriendsInterface = OnlineSub->GetFriendsInterface();
+		if (FriendsInterface.IsValid())
+		{
+			OnFriendsChangeDelegateHandle = FriendsInterface->AddOnFriendsChangeDelegate_Handle(0, OnFriendsChangeDelegate);
+		}
 	}
 }
 
@@ -71,7 +119,21 @@ void UNeutronSessionsManager::Finalize()
 	{
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		Sessions->ClearOnSessionUserInviteAcceptedDelegate_Handle(OnSessionUserInviteAcceptedDelegateHandle);
+
+		IOnlinePresencePtr Presence = OnlineSub->GetPresenceInterface();
+		if (Presence.IsValid())
+		{
+			Presence->ClearOnPresenceReceivedDelegate_Handle(OnPresenceReceivedDelegateHandle);
+		}
+
+		IOnlineFriendsPtr FriendsInterface = OnlineSub->GetFriendsInterface();
+		if (FriendsInterface.IsValid())
+		{
+			FriendsInterface->ClearOnFriendsChangeDelegate_Handle(0, OnFriendsChangeDelegateHandle);
+		}
 	}
+
+	PendingFriendSearches.Empty();
 }
 
 /*----------------------------------------------------
@@ -130,12 +192,17 @@ bool UNeutronSessionsManager::StartSession(FString URL, int32 MaxNumPlayers, boo
 		if (Sessions.IsValid() && UserId.IsValid())
 		{
 			ActionAfterError = FNeutronSessionAction(GetWorld()->GetName());
+			SetRetryOperation(FSimpleDelegate::CreateLambda(
+				[=]()
+				{
+					StartSession(URL, MaxNumPlayers, Public);
+				}));
 
 			// Player is already in session, leave it
 			if (Sessions->IsPlayerInSession(NAME_GameSession, *UserId))
 			{
 				ActionAfterDestroy = FNeutronSessionAction(URL, MaxNumPlayers, Public);
-				NetworkState       = ENeutronNetworkState::JoiningDestroying;
+				SetNetworkState(ENeutronNetworkState::JoiningDestroying);
 
 				OnDestroySessionCompleteDelegateHandle =
 					Sessions->AddOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegate);
@@ -160,7 +227,7 @@ bool UNeutronSessionsManager::StartSession(FString URL, int32 MaxNumPlayers, boo
 				NextURL = URL;
 				SessionSettings->Set(SETTING_MAPNAME, URL, EOnlineDataAdvertisementType::ViaOnlineService);
 
-				NetworkState = ENeutronNetworkState::Starting;
+				SetNetworkState(ENeutronNetworkState::Starting);
 
 				// Start
 				OnCreateSessionCompleteDelegateHandle =
@@ -188,7 +255,12 @@ bool UNeutronSessionsManager::EndSession(FString URL)
 		{
 			ActionAfterError   = FNeutronSessionAction(GetWorld()->GetName());
 			ActionAfterDestroy = FNeutronSessionAction(URL);
-			NetworkState       = ENeutronNetworkState::Ending;
+			SetRetryOperation(FSimpleDelegate::CreateLambda(
+				[=]()
+				{
+					EndSession(URL);
+				}));
+			SetNetworkState(ENeutronNetworkState::Ending);
 
 			OnDestroySessionCompleteDelegateHandle = Sessions->AddOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegate);
 			return Sessions->DestroySession(NAME_GameSession);
@@ -222,11 +294,23 @@ void UNeutronSessionsManager::SetSessionAdvertised(bool Public)
 
 bool UNeutronSessionsManager::SearchSessions(bool OnLan, FNeutronOnSessionSearchComplete Callback)
 {
-	NLOG("UNeutronSessionsManager::SearchSessions");
+	FNeutronSessionSearchParameters Parameters = DefaultSearchParameters;
+	Parameters.SearchLan                       = OnLan;
+	Parameters.SearchOnline                    = !OnLan;
+
+	return SearchSessions(Parameters, Callback);
+}
+
+bool UNeutronSessionsManager::SearchSessions(
+	const FNeutronSessionSearchParameters& Parameters, FNeutronOnSessionSearchComplete Callback, FNeutronOnSessionSearchUpdate Update)
+{
+	NLOG("UNeutronSessionsManager::SearchSessions : LAN %d, online %d", Parameters.SearchLan, Parameters.SearchOnline);
 
 	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
 
-	OnSessionListReady = Callback;
+	OnSessionListReady      = Callback;
+	OnSessionListUpdated    = Update;
+	CurrentSearchParameters = Parameters;
 
 	if (OnlineSub)
 	{
@@ -237,27 +321,87 @@ bool UNeutronSessionsManager::SearchSessions(bool OnLan, FNeutronOnSessionSearch
 		// Start searching
 		if (Sessions.IsValid() && UserId.IsValid())
 		{
-			SessionSearch = MakeShared<FOnlineSessionSearch>();
+			// Results from queries with other settings can't stand in for this one
+			if (!LanSearchCache.MatchesQuery(Parameters))
+			{
+				LanSearchCache = FNeutronSessionSearchCache();
+			}
+			if (!OnlineSearchCache.MatchesQuery(Parameters))
+			{
+				OnlineSearchCache = FNeutronSessionSearchCache();
+			}
 
-			SessionSearch->bIsLanQuery      = OnLan;
-			SessionSearch->MaxSearchResults = 10;
-			SessionSearch->PingBucketSize   = 100;
-			SessionSearch->TimeoutInSeconds = 3;
+			// Stream previous results right away
+			TArray<FOnlineSessionSearchResult> CachedResults = GetMergedSearchResults(Parameters.SearchLan, Parameters.SearchOnline);
+			if (CachedResults.Num())
+			{
+				OnSessionListUpdated.ExecuteIfBound(CachedResults);
+			}
 
-			SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+			// Only query again when results are missing or stale
+			const double CurrentTime = FPlatformTime::Seconds();
+			bool RefreshLan =
+				Parameters.SearchLan && (LanSearchCache.Time == 0 || CurrentTime - LanSearchCache.Time > Parameters.CacheDuration);
+			bool RefreshOnline =
+				Parameters.SearchOnline && (OnlineSearchCache.Time == 0 || CurrentTime - OnlineSearchCache.Time > Parameters.CacheDuration);
+			if (!RefreshLan && !RefreshOnline)
+			{
+				NLOG("UNeutronSessionsManager::SearchSessions : using cached results");
 
-			NetworkState = ENeutronNetworkState::Searching;
+				OnSessionListReady.ExecuteIfBound(CachedResults);
+				return true;
+			}
+
+			SetRetryOperation(FSimpleDelegate::CreateLambda(
+				[=]()
+				{
+					SearchSessions(Parameters, Callback, Update);
+				}));
+			SetNetworkState(ENeutronNetworkState::Searching);
+
+			// Run LAN and online queries together
+			PendingSearches.Empty();
+			QueuedSearches.Empty();
+			if (RefreshLan)
+			{
+				QueuedSearches.Add(true);
+			}
+			if (RefreshOnline)
+			{
+				QueuedSearches.Add(false);
+			}
 
 			// Start
-			TSharedRef<FOnlineSessionSearch> SearchSettingsRef = SessionSearch.ToSharedRef();
+			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
 			OnFindSessionsCompleteDelegateHandle = Sessions->AddOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegate);
-			return Sessions->FindSessions(*UserId, SearchSettingsRef);
+			StartQueuedSessionQueries();
+
+			// Nothing could be started
+			if (PendingSearches.Num() == 0)
+			{
+				Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+				SetNetworkState(GetIdleNetworkState());
+				return false;
+			}
+
+			return true;
 		}
 	}
 
 	return false;
 }
 
+TArray<FOnlineSessionSearchResult> UNeutronSessionsManager::GetCachedSearchResults() const
+{
+	return GetMergedSearchResults(true, true);
+}
+
+void UNeutronSessionsManager::InvalidateSearchCache()
+{
+	LanSearchCache    = FNeutronSessionSearchCache();
+	OnlineSearchCache = FNeutronSessionSearchCache();
+}
+
 bool UNeutronSessionsManager::JoinSearchResult(const FOnlineSessionSearchResult& SearchResult)
 {
 	NLOG("UNeutronSessionsManager::JoinSearchResult");
@@ -273,6 +417,19 @@ bool UNeutronSessionsManager::JoinSearchResult(const FOnlineSessionSearchResult&
 		// Start joining
 		if (Sessions.IsValid() && UserId.IsValid())
 		{
+			if (!IsRetrying)
+			{
+				Statistics.JoinAttempts++;
+				JoinStartTime = FPlatformTime::Seconds();
+			}
+
+			CurrentJoinResult = SearchResult;
+			SetRetryOperation(FSimpleDelegate::CreateLambda(
+				[=]()
+				{
+					JoinSearchResult(CurrentJoinResult);
+				}));
+
 			// Player is already in session, leave it
 			if (Sessions->IsPlayerInSession(NAME_GameSession, *UserId))
 			{
@@ -282,7 +439,7 @@ bool UNeutronSessionsManager::JoinSearchResult(const FOnlineSessionSearchResult&
 				ActionAfterError   = FNeutronSessionAction(GetWorld()->GetName());
 				ActionAfterDestroy = FNeutronSessionAction(SearchResult);
 
-				NetworkState = ENeutronNetworkState::JoiningDestroying;
+				SetNetworkState(ENeutronNetworkState::JoiningDestroying);
 
 				return Sessions->DestroySession(NAME_GameSession);
 			}
@@ -290,7 +447,7 @@ bool UNeutronSessionsManager::JoinSearchResult(const FOnlineSessionSearchResult&
 			// Join directly
 			else
 			{
-				NetworkState = ENeutronNetworkState::Joining;
+				SetNetworkState(ENeutronNetworkState::Joining);
 
 				OnJoinSessionCompleteDelegateHandle = Sessions->AddOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegate);
 
@@ -308,6 +465,24 @@ void UNeutronSessionsManager::ClearErrors()
 	LastNetworkErrorString = "";
 }
 
+void UNeutronSessionsManager::CancelOperation()
+{
+	if (IsBusy())
+	{
+		NLOG("UNeutronSessionsManager::CancelOperation : cancelling %s", *GetEnumString(NetworkState));
+
+		ClearSessionDelegates();
+
+		IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+		if (OnlineSub && OnlineSub->GetSessionInterface().IsValid() && NetworkState == ENeutronNetworkState::Searching)
+		{
+			OnlineSub->GetSessionInterface()->CancelFindSessions();
+		}
+
+		SetNetworkState(GetIdleNetworkState());
+	}
+}
+
 /*----------------------------------------------------
     Friends API
 ----------------------------------------------------*/
@@ -317,21 +492,51 @@ void UNeutronSessionsManager::SetAcceptedInvitationCallback(FNeutronOnFriendInvi
 	OnFriendInviteAccepted = Callback;
 }
 
-bool UNeutronSessionsManager::SearchFriends(FNeutronOnFriendSearchComplete Callback)
+void UNeutronSessionsManager::SetFriendsUpdateCallback(FNeutronOnFriendsUpdated Callback)
 {
-	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	OnFriendsUpdated = Callback;
+}
 
-	OnFriendListReady = Callback;
+bool UNeutronSessionsManager::SearchFriends(FNeutronOnFriendSearchComplete Callback, bool ForceRefresh)
+{
+	// Serve the cached roster immediately, refreshing it in the background when stale
+	if (FriendsCacheTime > 0)
+	{
+		Callback.ExecuteIfBound(Friends);
 
-	if (OnlineSub && OnlineSub->GetFriendsInterface())
+		if (ForceRefresh || FPlatformTime::Seconds() - FriendsCacheTime > FriendsCacheDuration)
+		{
+			RefreshFriends();
+		}
+
+		return true;
+	}
+
+	// Wait for the first read to complete
+	PendingFriendSearches.Add(Callback);
+	if (!RefreshFriends())
 	{
-		ULocalPlayer* Player = GameInstance->GetFirstGamePlayer();
+		PendingFriendSearches.Empty();
+		return false;
+	}
+
+	return true;
+}
+
+TArray<TSharedRef<FOnlineFriend>> UNeutronSessionsManager::GetFriends(int32 Offset, int32 Count) const
+{
+	TArray<TSharedRef<FOnlineFriend>> Page;
+
+	const int32 Start = FMath::Clamp(Offset, 0, Friends.Num());
+	const int32 End   = FMath::Clamp(Offset + Count, Start, Friends.Num());
+	Page.Reserve(End - Start);
 
-		return OnlineSub->GetFriendsInterface()->ReadFriendsList(
-			Player->GetControllerId(), EFriendsLists::ToString(EFriendsLists::Default), OnReadFriendsListCompleteDelegate);
+	for (int32 Index = Start; Index < End; Index++)
+	{
+		Page.Add(Friends[Index]);
 	}
 
-	return false;
+	return Page;
 }
 
 bool UNeutronSessionsManager::InviteFriend(FUniqueNetIdRepl FriendUserId)
@@ -365,11 +570,38 @@ bool UNeutronSessionsManager::JoinFriend(FUniqueNetIdRepl FriendUserId)
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		FUniqueNetIdRepl  UserId   = Player->GetPreferredUniqueNetId();
 
-		// Find the session and join
-		ActionAfterError = FNeutronSessionAction(GetWorld()->GetName());
-		OnFindFriendSessionCompleteDelegateHandle =
-			Sessions->AddOnFindFriendSessionCompleteDelegate_Handle(Player->GetControllerId(), OnFindFriendSessionCompleteDelegate);
-		return Sessions->FindFriendSession(*UserId, *FriendUserId);
+		// Find the session and join, going through the joining state for the deadline and retries
+		if (Sessions.IsValid() && UserId.IsValid() && FriendUserId.IsValid())
+		{
+			CurrentJoinFriendId = FriendUserId;
+			SetRetryOperation(FSimpleDelegate::CreateLambda(
+				[=]()
+				{
+					JoinFriend(CurrentJoinFriendId);
+				}));
+
+			const int32 ControllerId = Player->GetControllerId();
+			ActionAfterError         = FNeutronSessionAction(GetWorld()->GetName());
+			Sessions->ClearOnFindFriendSessionCompleteDelegate_Handle(ControllerId, OnFindFriendSessionCompleteDelegateHandle);
+			OnFindFriendSessionCompleteDelegateHandle =
+				Sessions->AddOnFindFriendSessionCompleteDelegate_Handle(ControllerId, OnFindFriendSessionCompleteDelegate);
+
+			FindingFriendSession = true;
+			SetNetworkState(ENeutronNetworkState::Joining);
+
+			if (Sessions->FindFriendSession(*UserId, *FriendUserId))
+			{
+				return true;
+			}
+
+			// The request was refused outright, unless it already completed
+			if (FindingFriendSession)
+			{
+				FindingFriendSession = false;
+				Sessions->ClearOnFindFriendSessionCompleteDelegate_Handle(ControllerId, OnFindFriendSessionCompleteDelegateHandle);
+				SetNetworkState(GetIdleNetworkState());
+			}
+		}
 	}
 
 	return false;
@@ -398,7 +630,7 @@ void UNeutronSessionsManager::OnCreateSessionComplete(FName SessionName, bool bW
 		}
 		else
 		{
-			NetworkState = ENeutronNetworkState::Offline;
+			SetNetworkState(ENeutronNetworkState::Offline);
 			OnSessionError(ENeutronNetworkError::StartFailed);
 		}
 	}
@@ -418,18 +650,21 @@ void UNeutronSessionsManager::OnStartOnlineGameComplete(FName SessionName, bool
 		Sessions->ClearOnStartSessionCompleteDelegate_Handle(OnStartSessionCompleteDelegateHandle);
 	}
 
-	// Travel to listen server
+	// Travel to listen server, or keep the current world if possible
 	if (bWasSuccessful)
 	{
-		NetworkState = ENeutronNetworkState::OnlineHost;
+		SetNetworkState(ENeutronNetworkState::OnlineHost);
 
-		GameInstance->GetFirstLocalPlayerController()->ClientTravel(NextURL + TEXT("?listen"), ETravelType::TRAVEL_Absolute, false);
+		if (!GameInstance->CanListenInPlace(NextURL) || !GameInstance->ListenInPlace())
+		{
+			GameInstance->GetFirstLocalPlayerController()->ClientTravel(NextURL + TEXT("?listen"), ETravelType::TRAVEL_Absolute, false);
+		}
 
 		NextURL = FString();
 	}
 	else
 	{
-		NetworkState = ENeutronNetworkState::Offline;
+		SetNetworkState(ENeutronNetworkState::Offline);
 		OnSessionError(ENeutronNetworkError::StartFailed);
 	}
 }
@@ -454,7 +689,7 @@ void UNeutronSessionsManager::OnDestroySessionComplete(FName SessionName, bool b
 	}
 
 	// An error happened
-	NetworkState = ENeutronNetworkState::Offline;
+	SetNetworkState(ENeutronNetworkState::Offline);
 	OnSessionError(ENeutronNetworkError::DestroyFailed);
 }
 
@@ -468,20 +703,234 @@ void UNeutronSessionsManager::OnFindSessionsComplete(bool bWasSuccessful)
 	IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 	if (Sessions.IsValid())
 	{
-		Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
-
-		EOnlineSessionState::Type SessionState = Sessions->GetSessionState(NAME_GameSession);
-		if (SessionState == EOnlineSessionState::NoSession || SessionState == EOnlineSessionState::Ended)
+		// Cache the results of all finished queries
+		const double CurrentTime = FPlatformTime::Seconds();
+		PendingSearches.RemoveAll(
+			[&](const TSharedPtr<FOnlineSessionSearch>& Search)
+			{
+				if (Search->SearchState == EOnlineAsyncTaskState::Done)
+				{
+					FNeutronSessionSearchCache& Cache = Search->bIsLanQuery ? LanSearchCache : OnlineSearchCache;
+					Cache.Results                     = Search->SearchResults;
+					Cache.Time                        = CurrentTime;
+					Cache.MaxSearchResults            = CurrentSearchParameters.MaxSearchResults;
+					Cache.TimeoutInSeconds            = CurrentSearchParameters.TimeoutInSeconds;
+					Cache.PingBucketSize              = CurrentSearchParameters.PingBucketSize;
+					return true;
+				}
+
+				return Search->SearchState == EOnlineAsyncTaskState::Failed;
+			});
+
+		// Start the queries that had to wait
+		StartQueuedSessionQueries();
+
+		TArray<FOnlineSessionSearchResult> Results =
+			GetMergedSearchResults(CurrentSearchParameters.SearchLan, CurrentSearchParameters.SearchOnline);
+
+		// All done, measure latencies before handing out the final list
+		if (PendingSearches.Num() == 0)
 		{
-			NetworkState = ENeutronNetworkState::Offline;
+			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+
+			if (StartLatencyProbes(Results))
+			{
+				OnSessionListUpdated.ExecuteIfBound(Results);
+			}
+			else
+			{
+				SetNetworkState(GetIdleNetworkState());
+				OnSessionListReady.ExecuteIfBound(Results);
+			}
 		}
+
+		// Stream partial results
 		else
 		{
-			NetworkState = ENeutronNetworkState::OnlineHost;
+			OnSessionListUpdated.ExecuteIfBound(Results);
 		}
+	}
+}
+
+void UNeutronSessionsManager::StartQueuedSessionQueries()
+{
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	NCHECK(OnlineSub);
+
+	ULocalPlayer*     Player   = GameInstance->GetFirstGamePlayer();
+	IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
+	FUniqueNetIdRepl  UserId   = Player->GetPreferredUniqueNetId();
 
-		OnSessionListReady.ExecuteIfBound(SessionSearch->SearchResults);
+	if (Sessions.IsValid() && UserId.IsValid())
+	{
+		while (QueuedSearches.Num())
+		{
+			TSharedRef<FOnlineSessionSearch> Search = MakeShared<FOnlineSessionSearch>();
+
+			Search->bIsLanQuery      = QueuedSearches[0];
+			Search->MaxSearchResults = CurrentSearchParameters.MaxSearchResults;
+			Search->PingBucketSize   = CurrentSearchParameters.PingBucketSize;
+			Search->TimeoutInSeconds = CurrentSearchParameters.TimeoutInSeconds;
+
+			Search->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+
+			PendingSearches.Add(Search);
+			if (Sessions->FindSessions(*UserId, Search))
+			{
+				QueuedSearches.RemoveAt(0);
+			}
+			else
+			{
+				PendingSearches.Remove(Search);
+
+				// The subsystem only supports one query at a time, try again once the current one is done
+				if (PendingSearches.Num())
+				{
+					break;
+				}
+
+				NERR("UNeutronSessionsManager::StartQueuedSessionQueries : failed to start query");
+				QueuedSearches.RemoveAt(0);
+			}
+		}
+	}
+}
+
+TArray<FOnlineSessionSearchResult> UNeutronSessionsManager::GetMergedSearchResults(bool IncludeLan, bool IncludeOnline) const
+{
+	TArray<FOnlineSessionSearchResult> Results;
+	TSet<FString>                      SessionIds;
+
+	auto AddResults = [&](const FNeutronSessionSearchCache& Cache)
+	{
+		for (const FOnlineSessionSearchResult& Result : Cache.Results)
+		{
+			bool AlreadyPresent = false;
+			SessionIds.Add(Result.GetSessionIdStr(), &AlreadyPresent);
+			if (!AlreadyPresent)
+			{
+				Results.Add(Result);
+			}
+		}
+	};
+
+	if (IncludeLan)
+	{
+		AddResults(LanSearchCache);
+	}
+	if (IncludeOnline)
+	{
+		AddResults(OnlineSearchCache);
+	}
+
+	// Use measured latencies when available
+	for (FOnlineSessionSearchResult& Result : Results)
+	{
+		const int32* Latency = SessionLatencies.Find(Result.GetSessionIdStr());
+		if (Latency)
+		{
+			Result.PingInMs = *Latency;
+		}
 	}
+
+	// Rank sessions
+	Results.StableSort(
+		[this](const FOnlineSessionSearchResult& A, const FOnlineSessionSearchResult& B)
+		{
+			return GetSessionCost(A) < GetSessionCost(B);
+		});
+
+	return Results;
+}
+
+bool UNeutronSessionsManager::StartLatencyProbes(const TArray<FOnlineSessionSearchResult>& Results)
+{
+	LatencyProbeGeneration++;
+	PendingLatencyProbes = 0;
+
+	// Latencies from previous searches are stale, and hosts that don't answer fall back to the subsystem latency
+	SessionLatencies.Reset();
+
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	NCHECK(OnlineSub);
+	IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
+
+	if (ProbeSessionLatency && Sessions.IsValid())
+	{
+		TWeakObjectPtr<UNeutronSessionsManager> WeakThis   = this;
+		uint32                                  Generation = LatencyProbeGeneration;
+
+		for (const FOnlineSessionSearchResult& Result : Results)
+		{
+			// Only hosts with an address can be probed, others keep the latency reported by the subsystem
+			FString ConnectString;
+			if (Sessions->GetResolvedConnectString(Result, NAME_GamePort, ConnectString))
+			{
+				FString Address = ConnectString;
+				ConnectString.Split(TEXT(":"), &Address, nullptr, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+
+				FString SessionId = Result.GetSessionIdStr();
+				PendingLatencyProbes++;
+
+				FIcmp::IcmpEcho(Address, LatencyProbeTimeout,
+					[WeakThis, Generation, SessionId](FIcmpEchoResult EchoResult)
+					{
+						if (WeakThis.IsValid())
+						{
+							WeakThis->OnLatencyProbeComplete(Generation, SessionId, EchoResult);
+						}
+					});
+			}
+		}
+
+		NLOG("UNeutronSessionsManager::StartLatencyProbes : probing %d hosts", PendingLatencyProbes);
+	}
+
+	return PendingLatencyProbes > 0;
+}
+
+void UNeutronSessionsManager::OnLatencyProbeComplete(uint32 Generation, FString SessionId, FIcmpEchoResult Result)
+{
+	// Ignore probes from a cancelled or previous search
+	if (Generation != LatencyProbeGeneration || PendingLatencyProbes <= 0)
+	{
+		return;
+	}
+
+	if (Result.Status == EIcmpResponseStatus::Success)
+	{
+		SessionLatencies.Add(SessionId, FMath::RoundToInt(Result.Time * 1000));
+	}
+	else
+	{
+		NLOG("UNeutronSessionsManager::OnLatencyProbeComplete : no answer from %s", *Result.ResolvedAddress);
+	}
+
+	// All probes are done
+	PendingLatencyProbes--;
+	if (PendingLatencyProbes == 0 && NetworkState == ENeutronNetworkState::Searching)
+	{
+		SetNetworkState(GetIdleNetworkState());
+
+		OnSessionListReady.ExecuteIfBound(
+			GetMergedSearchResults(CurrentSearchParameters.SearchLan, CurrentSearchParameters.SearchOnline));
+	}
+}
+
+float UNeutronSessionsManager::GetSessionCost(const FOnlineSessionSearchResult& Result) const
+{
+	const int32 MaxPlayers = Result.Session.SessionSettings.NumPublicConnections;
+	const int32 FreeSlots  = Result.Session.NumOpenPublicConnections;
+
+	// Full sessions can't be joined
+	if (MaxPlayers > 0 && FreeSlots <= 0)
+	{
+		return MAX_FLT;
+	}
+
+	float Load = MaxPlayers > 0 ? 1.0f - static_cast<float>(FreeSlots) / MaxPlayers : 0.0f;
+
+	return SessionLatencyWeight * Result.PingInMs + SessionLoadWeight * Load;
 }
 
 void UNeutronSessionsManager::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
@@ -500,7 +949,12 @@ void UNeutronSessionsManager::OnJoinSessionComplete(FName SessionName, EOnJoinSe
 		// Travel to server
 		if (Result == EOnJoinSessionCompleteResult::Success)
 		{
-			NetworkState = ENeutronNetworkState::OnlineClient;
+			SetNetworkState(ENeutronNetworkState::OnlineClient);
+
+			Statistics.JoinSuccesses++;
+			Statistics.LastJoinTime = FPlatformTime::Seconds() - JoinStartTime;
+			Statistics.TotalJoinTime += Statistics.LastJoinTime;
+			NLOG("UNeutronSessionsManager::OnJoinSessionComplete : joined in %.2fs", Statistics.LastJoinTime);
 
 			FString TravelURL;
 			if (Sessions->GetResolvedConnectString(SessionName, TravelURL))
@@ -509,17 +963,26 @@ void UNeutronSessionsManager::OnJoinSessionComplete(FName SessionName, EOnJoinSe
 			}
 		}
 
+		// Retry transient errors
+		else if ((Result == EOnJoinSessionCompleteResult::CouldNotRetrieveAddress || Result == EOnJoinSessionCompleteResult::UnknownError) &&
+				 ScheduleRetry())
+		{
+			NLOG("UNeutronSessionsManager::OnJoinSessionComplete : join failed, retrying");
+		}
+
 		// Handle error
 		else
 		{
+			Statistics.JoinFailures++;
+
 			EOnlineSessionState::Type SessionState = Sessions->GetSessionState(SessionName);
 			if (SessionState == EOnlineSessionState::NoSession || SessionState == EOnlineSessionState::Ended)
 			{
-				NetworkState = ENeutronNetworkState::Offline;
+				SetNetworkState(ENeutronNetworkState::Offline);
 			}
 			else
 			{
-				NetworkState = ENeutronNetworkState::OnlineHost;
+				SetNetworkState(ENeutronNetworkState::OnlineHost);
 			}
 
 			switch (Result)
@@ -545,22 +1008,114 @@ void UNeutronSessionsManager::OnJoinSessionComplete(FName SessionName, EOnJoinSe
     Friends internals
 ----------------------------------------------------*/
 
+bool UNeutronSessionsManager::RefreshFriends()
+{
+	if (FriendsRefreshing)
+	{
+		return true;
+	}
+
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	if (OnlineSub && OnlineSub->GetFriendsInterface())
+	{
+		ULocalPlayer* Player = GameInstance->GetFirstGamePlayer();
+
+		// The read may complete before returning, so flag it as ongoing first
+		FriendsRefreshing = true;
+		if (!OnlineSub->GetFriendsInterface()->ReadFriendsList(
+				Player->GetControllerId(), EFriendsLists::ToString(EFriendsLists::Default), OnReadFriendsListCompleteDelegate))
+		{
+			FriendsRefreshing = false;
+			return false;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
 void UNeutronSessionsManager::OnReadFriendsComplete(
 	int32 LocalPlayer, bool bWasSuccessful, const FString& ListName, const FString& ErrorStr)
 {
-	TArray<TSharedRef<FOnlineFriend>> Friends;
+	NLOG("UNeutronSessionsManager::OnReadFriendsComplete : success %d", bWasSuccessful);
 
+	FriendsRefreshing = false;
+
+	// Replace the roster, keeping the previous one on failure
 	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
 	if (OnlineSub && OnlineSub->GetFriendsInterface().IsValid() && bWasSuccessful)
 	{
-		ULocalPlayer*     Player   = GameInstance->GetFirstGamePlayer();
-		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
+		ULocalPlayer* Player = GameInstance->GetFirstGamePlayer();
 
+		Friends.Empty();
 		OnlineSub->GetFriendsInterface()->GetFriendsList(
 			Player->GetControllerId(), EFriendsLists::ToString(EFriendsLists::Default), Friends);
+
+		FriendsCacheTime = FPlatformTime::Seconds();
+		ChangedFriends.Empty();
+		SortFriends();
+
+		OnFriendsUpdated.ExecuteIfBound(Friends);
+	}
+	else
+	{
+		NERR("UNeutronSessionsManager::OnReadFriendsComplete : failed with '%s'", *ErrorStr);
+	}
+
+	// Serve the waiting requests, which may add new ones
+	TArray<FNeutronOnFriendSearchComplete> Callbacks = MoveTemp(PendingFriendSearches);
+	PendingFriendSearches.Empty();
+	for (const FNeutronOnFriendSearchComplete& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound(Friends);
 	}
+}
 
-	OnFriendListReady.ExecuteIfBound(Friends);
+void UNeutronSessionsManager::OnPresenceReceived(const FUniqueNetId& UserId, const TSharedRef<FOnlineUserPresence>& Presence)
+{
+	// Only friends in the roster are tracked, the presence data is shared with the friend entry
+	FString Id = UserId.ToString();
+	if (FriendIndices.Contains(Id))
+	{
+		ChangedFriends.Add(Id);
+	}
+}
+
+void UNeutronSessionsManager::OnFriendsChange()
+{
+	NLOG("UNeutronSessionsManager::OnFriendsChange");
+
+	RefreshFriends();
+}
+
+void UNeutronSessionsManager::SortFriends()
+{
+	Friends.StableSort(
+		[](const TSharedRef<FOnlineFriend>& A, const TSharedRef<FOnlineFriend>& B)
+		{
+			const FOnlineUserPresence& PresenceA = A->GetPresence();
+			const FOnlineUserPresence& PresenceB = B->GetPresence();
+
+			if (PresenceA.bIsOnline != PresenceB.bIsOnline)
+			{
+				return PresenceA.bIsOnline;
+			}
+			else if (PresenceA.bIsPlayingThisGame != PresenceB.bIsPlayingThisGame)
+			{
+				return PresenceA.bIsPlayingThisGame;
+			}
+			else
+			{
+				return A->GetDisplayName() < B->GetDisplayName();
+			}
+		});
+
+	FriendIndices.Empty(Friends.Num());
+	for (int32 Index = 0; Index < Friends.Num(); Index++)
+	{
+		FriendIndices.Add(Friends[Index]->GetUserId()->ToString(), Index);
+	}
 }
 
 void UNeutronSessionsManager::OnSessionUserInviteAccepted(
@@ -583,6 +1138,13 @@ void UNeutronSessionsManager::OnFindFriendSessionComplete(
 	{
 		Sessions->ClearOnFindFriendSessionCompleteDelegate_Handle(LocalPlayer, OnFindFriendSessionCompleteDelegateHandle);
 
+		// Ignore answers to a request that was cancelled or timed out
+		if (!FindingFriendSession)
+		{
+			return;
+		}
+		FindingFriendSession = false;
+
 		// Join session
 		if (bWasSuccessful && SearchResult.Num() > 0 && SearchResult[0].Session.OwningUserId.IsValid() &&
 			SearchResult[0].Session.SessionInfo.IsValid())
@@ -596,11 +1158,11 @@ void UNeutronSessionsManager::OnFindFriendSessionComplete(
 			EOnlineSessionState::Type SessionState = Sessions->GetSessionState(NAME_GameSession);
 			if (SessionState == EOnlineSessionState::NoSession || SessionState == EOnlineSessionState::Ended)
 			{
-				NetworkState = ENeutronNetworkState::Offline;
+				SetNetworkState(ENeutronNetworkState::Offline);
 			}
 			else
 			{
-				NetworkState = ENeutronNetworkState::OnlineHost;
+				SetNetworkState(ENeutronNetworkState::OnlineHost);
 			}
 
 			OnSessionError(ENeutronNetworkError::JoinFriendFailed);
@@ -677,7 +1239,7 @@ void UNeutronSessionsManager::ProcessAction(FNeutronSessionAction Action)
 		// We killed the previous session to join a specific one, join it
 		if (Action.SessionToJoin.IsValid())
 		{
-			NetworkState = ENeutronNetworkState::Joining;
+			SetNetworkState(ENeutronNetworkState::Joining);
 
 			ULocalPlayer* Player                = GameInstance->GetFirstGamePlayer();
 			OnJoinSessionCompleteDelegateHandle = Sessions->AddOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegate);
@@ -697,7 +1259,7 @@ void UNeutronSessionsManager::ProcessAction(FNeutronSessionAction Action)
 			// Exit multiplayer and go back to a level
 			else
 			{
-				NetworkState = ENeutronNetworkState::Offline;
+				SetNetworkState(ENeutronNetworkState::Offline);
 
 				GameInstance->GetFirstLocalPlayerController()->ClientTravel(Action.URL, ETravelType::TRAVEL_Absolute, false);
 			}
@@ -705,6 +1267,225 @@ void UNeutronSessionsManager::ProcessAction(FNeutronSessionAction Action)
 	}
 }
 
+void UNeutronSessionsManager::SetNetworkState(ENeutronNetworkState NewState)
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	if (NewState != NetworkState)
+	{
+		NLOG("UNeutronSessionsManager::SetNetworkState : %s -> %s", *GetEnumString(NetworkState), *GetEnumString(NewState));
+
+		// Keep a short history for diagnostics
+		TransitionLog.Add(FNeutronSessionTransition(NetworkState, NewState, CurrentTime));
+		if (TransitionLog.Num() > 32)
+		{
+			TransitionLog.RemoveAt(0);
+		}
+
+		UNeutronMenuManager::Get()->NotifyGameObjectsChanged(FNeutronGameMenuDependencies::Sessions);
+	}
+
+	NetworkState   = NewState;
+	StateStartTime = CurrentTime;
+
+	// The operation is over once we're back to a stable state
+	if (!IsBusy())
+	{
+		RetryOperation.Unbind();
+		RetryCount = 0;
+		RetryTime  = 0;
+	}
+}
+
+ENeutronNetworkState UNeutronSessionsManager::GetIdleNetworkState() const
+{
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+
+	if (OnlineSub && OnlineSub->GetSessionInterface().IsValid())
+	{
+		EOnlineSessionState::Type SessionState = OnlineSub->GetSessionInterface()->GetSessionState(NAME_GameSession);
+		if (SessionState != EOnlineSessionState::NoSession && SessionState != EOnlineSessionState::Ended)
+		{
+			return ENeutronNetworkState::OnlineHost;
+		}
+	}
+
+	return ENeutronNetworkState::Offline;
+}
+
+float UNeutronSessionsManager::GetStateTimeout(ENeutronNetworkState State) const
+{
+	switch (State)
+	{
+		case ENeutronNetworkState::Starting:
+			return StartTimeout;
+		case ENeutronNetworkState::Searching:
+			return SearchTimeout;
+		case ENeutronNetworkState::Joining:
+			return JoinTimeout;
+		case ENeutronNetworkState::JoiningDestroying:
+		case ENeutronNetworkState::Ending:
+			return DestroyTimeout;
+		default:
+			return 0;
+	}
+}
+
+void UNeutronSessionsManager::SetRetryOperation(FSimpleDelegate Operation)
+{
+	if (!IsRetrying)
+	{
+		RetryCount = 0;
+	}
+
+	RetryOperation = Operation;
+	RetryTime      = 0;
+}
+
+bool UNeutronSessionsManager::ScheduleRetry()
+{
+	if (RetryOperation.IsBound() && RetryCount < MaxRetries)
+	{
+		RetryCount++;
+		Statistics.Retries++;
+
+		float Delay = RetryDelay * FMath::Pow(2.0f, RetryCount - 1);
+		RetryTime   = FPlatformTime::Seconds() + Delay;
+
+		NLOG("UNeutronSessionsManager::ScheduleRetry : retry %d/%d in %.1fs", RetryCount, MaxRetries, Delay);
+
+		return true;
+	}
+
+	return false;
+}
+
+void UNeutronSessionsManager::OnStateTimeout()
+{
+	ENeutronNetworkState TimedOutState = NetworkState;
+
+	NERR("UNeutronSessionsManager::OnStateTimeout : no answer in state %s", *GetEnumString(TimedOutState));
+	Statistics.Timeouts++;
+
+	// Forget about the stalled request
+	bool WasFindingFriendSession = FindingFriendSession;
+	ClearSessionDelegates();
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	if (OnlineSub && OnlineSub->GetSessionInterface().IsValid() && TimedOutState == ENeutronNetworkState::Searching)
+	{
+		OnlineSub->GetSessionInterface()->CancelFindSessions();
+	}
+
+	if (ScheduleRetry())
+	{
+		return;
+	}
+
+	// Out of retries, fail the operation
+	SetNetworkState(GetIdleNetworkState());
+	switch (TimedOutState)
+	{
+		case ENeutronNetworkState::Starting:
+			OnSessionError(ENeutronNetworkError::StartFailed);
+			break;
+
+		case ENeutronNetworkState::Searching:
+			OnSessionListReady.ExecuteIfBound(
+				GetMergedSearchResults(CurrentSearchParameters.SearchLan, CurrentSearchParameters.SearchOnline));
+			break;
+
+		case ENeutronNetworkState::Joining:
+			Statistics.JoinFailures++;
+			OnSessionError(
+				WasFindingFriendSession ? ENeutronNetworkError::JoinFriendFailed : ENeutronNetworkError::JoinSessionConnectionError);
+			break;
+
+		default:
+			OnSessionError(ENeutronNetworkError::DestroyFailed);
+			break;
+	}
+}
+
+void UNeutronSessionsManager::ClearSessionDelegates()
+{
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+
+	PendingSearches.Empty();
+	QueuedSearches.Empty();
+	LatencyProbeGeneration++;
+	PendingLatencyProbes = 0;
+	FindingFriendSession = false;
+
+	if (OnlineSub)
+	{
+		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
+		if (Sessions.IsValid())
+		{
+			Sessions->ClearOnCreateSessionCompleteDelegate_Handle(OnCreateSessionCompleteDelegateHandle);
+			Sessions->ClearOnStartSessionCompleteDelegate_Handle(OnStartSessionCompleteDelegateHandle);
+			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+			Sessions->ClearOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegateHandle);
+			Sessions->ClearOnDestroySessionCompleteDelegate_Handle(OnDestroySessionCompleteDelegateHandle);
+
+			ULocalPlayer* Player = GameInstance ? GameInstance->GetFirstGamePlayer() : nullptr;
+			if (Player)
+			{
+				Sessions->ClearOnFindFriendSessionCompleteDelegate_Handle(
+					Player->GetControllerId(), OnFindFriendSessionCompleteDelegateHandle);
+			}
+		}
+	}
+}
+
+/*----------------------------------------------------
+    Tick
+----------------------------------------------------*/
+
+void UNeutronSessionsManager::Tick(float DeltaTime)
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	// Run the scheduled retry
+	if (RetryTime > 0)
+	{
+		if (CurrentTime >= RetryTime)
+		{
+			NLOG("UNeutronSessionsManager::Tick : retrying in state %s", *GetEnumString(NetworkState));
+
+			// The operation will register itself again, so run a copy
+			FSimpleDelegate Operation = RetryOperation;
+			RetryTime                 = 0;
+			IsRetrying                = true;
+			Operation.ExecuteIfBound();
+			IsRetrying = false;
+		}
+	}
+
+	// Enforce the deadline of the current state
+	else
+	{
+		float Timeout = GetStateTimeout(NetworkState);
+		if (Timeout > 0 && CurrentTime - StateStartTime > Timeout)
+		{
+			OnStateTimeout();
+		}
+	}
+
+	// Notify presence changes once per frame, as a batch
+	if (ChangedFriends.Num())
+	{
+		TArray<TSharedRef<FOnlineFriend>> Changed;
+		for (const FString& Id : ChangedFriends)
+		{
+			Changed.Add(Friends[FriendIndices[Id]]);
+		}
+		ChangedFriends.Empty();
+
+		SortFriends();
+		OnFriendsUpdated.ExecuteIfBound(Changed);
+	}
+}
+
 /*----------------------------------------------------
     Getters
 ----------------------------------------------------*/
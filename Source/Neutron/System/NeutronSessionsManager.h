@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Tickable.h"
 
 #include "GameFramework/OnlineReplStructs.h"
 #include "Net/UnrealNetwork.h"
@@ -75,18 +76,125 @@ struct FNeutronSessionAction
 	bool                       Public;
 };
 
+/** Network state change, for diagnostics */
+struct FNeutronSessionTransition
+{
+	FNeutronSessionTransition() : From(ENeutronNetworkState::Offline), To(ENeutronNetworkState::Offline), Time(0)
+	{}
+
+	FNeutronSessionTransition(ENeutronNetworkState F, ENeutronNetworkState T, double NewTime) : From(F), To(T), Time(NewTime)
+	{}
+
+	ENeutronNetworkState From;
+	ENeutronNetworkState To;
+	double               Time;
+};
+
+/** Session flow statistics */
+struct FNeutronSessionStatistics
+{
+	FNeutronSessionStatistics()
+		: JoinAttempts(0), JoinSuccesses(0), JoinFailures(0), Timeouts(0), Retries(0), LastJoinTime(0), TotalJoinTime(0)
+	{}
+
+	/** Get the ratio of successful joins */
+	float GetJoinSuccessRate() const
+	{
+		return JoinAttempts > 0 ? static_cast<float>(JoinSuccesses) / JoinAttempts : 0.0f;
+	}
+
+	/** Get the average time from join request to success in seconds */
+	double GetAverageJoinTime() const
+	{
+		return JoinSuccesses > 0 ? TotalJoinTime / JoinSuccesses : 0.0;
+	}
+
+	int32  JoinAttempts;
+	int32  JoinSuccesses;
+	int32  JoinFailures;
+	int32  Timeouts;
+	int32  Retries;
+	double LastJoinTime;
+	double TotalJoinTime;
+};
+
+/** Session search settings */
+USTRUCT()
+struct FNeutronSessionSearchParameters
+{
+	GENERATED_BODY()
+
+	FNeutronSessionSearchParameters()
+		: SearchLan(false), SearchOnline(true), MaxSearchResults(10), TimeoutInSeconds(3), PingBucketSize(100), CacheDuration(30)
+	{}
+
+	// Query sessions on the local network
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool SearchLan;
+
+	// Query sessions through the online service
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool SearchOnline;
+
+	// Maximum results per query
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	int32 MaxSearchResults;
+
+	// Time in seconds the online subsystem spends on a query
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float TimeoutInSeconds;
+
+	// Ping bucket size for online subsystem sorting
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	int32 PingBucketSize;
+
+	// Time in seconds during which cached results are served without a new query
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float CacheDuration;
+};
+
+/** Cached results of a session query */
+struct FNeutronSessionSearchCache
+{
+	FNeutronSessionSearchCache() : Time(0), MaxSearchResults(0), TimeoutInSeconds(0), PingBucketSize(0)
+	{}
+
+	/** Check whether these results were obtained with the query settings of Parameters */
+	bool MatchesQuery(const FNeutronSessionSearchParameters& Parameters) const
+	{
+		return MaxSearchResults == Parameters.MaxSearchResults && TimeoutInSeconds == Parameters.TimeoutInSeconds &&
+			   PingBucketSize == Parameters.PingBucketSize;
+	}
+
+	TArray<FOnlineSessionSearchResult> Results;
+	double                             Time;
+
+	// Query settings the results were obtained with
+	int32 MaxSearchResults;
+	float TimeoutInSeconds;
+	int32 PingBucketSize;
+};
+
 // Session delegate
 DECLARE_DELEGATE_OneParam(FNeutronOnSessionSearchComplete, TArray<FOnlineSessionSearchResult>);
 
+// Session delegate for partial results
+DECLARE_DELEGATE_OneParam(FNeutronOnSessionSearchUpdate, const TArray<FOnlineSessionSearchResult>&);
+
 // Friend delegate
-DECLARE_DELEGATE_OneParam(FNeutronOnFriendSearchComplete, TArray<TSharedRef<FOnlineFriend>>);
+DECLARE_DELEGATE_OneParam(FNeutronOnFriendSearchComplete, const TArray<TSharedRef<FOnlineFriend>>&);
+
+// Friend delegate for roster changes
+DECLARE_DELEGATE_OneParam(FNeutronOnFriendsUpdated, const TArray<TSharedRef<FOnlineFriend>>&);
 
 // Friend delegate
 DECLARE_DELEGATE_OneParam(FNeutronOnFriendInviteAccepted, const FOnlineSessionSearchResult&);
 
 /** Game instance class */
 UCLASS(ClassGroup = (Neutron))
-class NEUTRON_API UNeutronSessionsManager : public UObject
+class NEUTRON_API UNeutronSessionsManager
+	: public UObject
+	, public FTickableGameObject
 {
 	GENERATED_BODY()
 
@@ -135,12 +243,25 @@ public:
 	/** Search for sessions */
 	bool SearchSessions(bool OnLan, FNeutronOnSessionSearchComplete Callback);
 
+	/** Search for sessions with custom parameters, streaming merged results to Update as they arrive from the cache and each query */
+	bool SearchSessions(const FNeutronSessionSearchParameters& Parameters, FNeutronOnSessionSearchComplete Callback,
+		FNeutronOnSessionSearchUpdate Update = FNeutronOnSessionSearchUpdate());
+
+	/** Get the merged results of previous searches, regardless of their age */
+	TArray<FOnlineSessionSearchResult> GetCachedSearchResults() const;
+
+	/** Forget the results of previous searches */
+	void InvalidateSearchCache();
+
 	/** Join a session */
 	bool JoinSearchResult(const FOnlineSessionSearchResult& SearchResult);
 
 	/** Reset the session errors */
 	void ClearErrors();
 
+	/** Abort the ongoing session operation and any scheduled retry */
+	void CancelOperation();
+
 	/*----------------------------------------------------
 	    Friends API
 	----------------------------------------------------*/
@@ -148,8 +269,20 @@ public:
 	/** Set the callback for accepted friend invitations */
 	void SetAcceptedInvitationCallback(FNeutronOnFriendInviteAccepted Callback);
 
-	/** Read the list of online friends */
-	bool SearchFriends(FNeutronOnFriendSearchComplete Callback);
+	/** Set the callback for friends whose presence changed, or the whole roster after a refresh */
+	void SetFriendsUpdateCallback(FNeutronOnFriendsUpdated Callback);
+
+	/** Get the list of online friends, from the cache when available, refreshing it in the background when stale */
+	bool SearchFriends(FNeutronOnFriendSearchComplete Callback, bool ForceRefresh = false);
+
+	/** Get the number of cached friends */
+	int32 GetFriendCount() const
+	{
+		return Friends.Num();
+	}
+
+	/** Get a page of cached friends, online friends first */
+	TArray<TSharedRef<FOnlineFriend>> GetFriends(int32 Offset, int32 Count) const;
 
 	/** Invite a friend to the session */
 	bool InviteFriend(FUniqueNetIdRepl FriendUserId);
@@ -157,6 +290,28 @@ public:
 	/** Join a friend's session */
 	bool JoinFriend(FUniqueNetIdRepl FriendUserId);
 
+	/*----------------------------------------------------
+	    Tick
+	----------------------------------------------------*/
+
+	virtual void              Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override
+	{
+		return ETickableTickType::Always;
+	}
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UNeutronSessionsManager, STATGROUP_Tickables);
+	}
+	virtual bool IsTickableWhenPaused() const
+	{
+		return true;
+	}
+	virtual bool IsTickableInEditor() const
+	{
+		return false;
+	}
+
 protected:
 
 	/*----------------------------------------------------
@@ -175,6 +330,21 @@ protected:
 	/** Sessions have been found */
 	void OnFindSessionsComplete(bool bWasSuccessful);
 
+	/** Start the queued session queries, keeping them queued if the subsystem can't run them in parallel */
+	void StartQueuedSessionQueries();
+
+	/** Merge the cached LAN and online results, without duplicates, best sessions first */
+	TArray<FOnlineSessionSearchResult> GetMergedSearchResults(bool IncludeLan, bool IncludeOnline) const;
+
+	/** Measure the latency to the hosts of search results, return false if no probe could be started */
+	bool StartLatencyProbes(const TArray<FOnlineSessionSearchResult>& Results);
+
+	/** A latency probe has returned */
+	void OnLatencyProbeComplete(uint32 Generation, FString SessionId, struct FIcmpEchoResult Result);
+
+	/** Get the ranking cost of a session, lower is better */
+	float GetSessionCost(const FOnlineSessionSearchResult& Result) const;
+
 	/** Session has joined */
 	void OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
 
@@ -189,6 +359,18 @@ protected:
 	void OnSessionUserInviteAccepted(
 		bool bWasSuccess, const int32 ControllerId, TSharedPtr<const FUniqueNetId> UserId, const FOnlineSessionSearchResult& InviteResult);
 
+	/** Start reading the friends list, unless already in progress */
+	bool RefreshFriends();
+
+	/** A friend's presence has changed */
+	void OnPresenceReceived(const FUniqueNetId& UserId, const TSharedRef<FOnlineUserPresence>& Presence);
+
+	/** The friends list has changed */
+	void OnFriendsChange();
+
+	/** Sort friends by presence then name, and index them */
+	void SortFriends();
+
 	/** Friend sessions are available */
 	void OnFindFriendSessionComplete(int32 LocalPlayer, bool bWasSuccessful, const TArray<FOnlineSessionSearchResult>& SearchResult);
 
@@ -205,6 +387,81 @@ protected:
 	/** Process an action */
 	void ProcessAction(FNeutronSessionAction Action);
 
+	/** Move to a new network state */
+	void SetNetworkState(ENeutronNetworkState NewState);
+
+	/** Get the state to return to when no operation is running */
+	ENeutronNetworkState GetIdleNetworkState() const;
+
+	/** Get the maximum time allowed in a state, or 0 for none */
+	float GetStateTimeout(ENeutronNetworkState State) const;
+
+	/** Register the operation to run again if the current one times out */
+	void SetRetryOperation(FSimpleDelegate Operation);
+
+	/** Schedule a retry with backoff, return false when out of retries */
+	bool ScheduleRetry();
+
+	/** The current state didn't complete in time */
+	void OnStateTimeout();
+
+	/** Remove all pending session callbacks */
+	void ClearSessionDelegates();
+
+	/*----------------------------------------------------
+	    Properties
+	----------------------------------------------------*/
+
+public:
+
+	// Time in seconds allowed to create and start a session
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float StartTimeout;
+
+	// Time in seconds allowed to search for sessions
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float SearchTimeout;
+
+	// Time in seconds allowed to join a session
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float JoinTimeout;
+
+	// Time in seconds allowed to leave a session
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float DestroyTimeout;
+
+	// Default session search settings
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	FNeutronSessionSearchParameters DefaultSearchParameters;
+
+	// Measure the latency to session hosts after a search
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	bool ProbeSessionLatency;
+
+	// Time in seconds after which a latency probe is abandoned
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float LatencyProbeTimeout;
+
+	// Ranking cost per millisecond of latency
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float SessionLatencyWeight;
+
+	// Ranking cost of a session with all slots taken, scaled down for emptier sessions
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float SessionLoadWeight;
+
+	// Number of automatic retries after a timeout or a transient failure
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	int32 MaxRetries;
+
+	// Delay in seconds before the first retry, doubled on each subsequent one
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float RetryDelay;
+
+	// Time in seconds after which the cached friends list is refreshed in the background
+	UPROPERTY(Category = Neutron, EditDefaultsOnly)
+	float FriendsCacheDuration;
+
 private:
 
 	/*----------------------------------------------------
@@ -216,7 +473,6 @@ private:
 
 	// Data
 	TSharedPtr<class FOnlineSessionSettings> SessionSettings;
-	TSharedPtr<class FOnlineSessionSearch>   SessionSearch;
 	FString                                  NextURL;
 	FNeutronSessionAction                    ActionAfterDestroy;
 	FNeutronSessionAction                    ActionAfterError;
@@ -227,6 +483,40 @@ private:
 	ENeutronNetworkError LastNetworkError;
 	FString              LastNetworkErrorString;
 
+	// State machine
+	double                            StateStartTime;
+	TArray<FNeutronSessionTransition> TransitionLog;
+	FSimpleDelegate                   RetryOperation;
+	int32                             RetryCount;
+	double                            RetryTime;
+	bool                              IsRetrying;
+
+	// Session search
+	FNeutronSessionSearchParameters                CurrentSearchParameters;
+	TArray<TSharedPtr<class FOnlineSessionSearch>> PendingSearches;
+	TArray<bool>                                   QueuedSearches;
+	FNeutronSessionSearchCache                     LanSearchCache;
+	FNeutronSessionSearchCache                     OnlineSearchCache;
+
+	// Latency probing
+	TMap<FString, int32> SessionLatencies;
+	uint32               LatencyProbeGeneration;
+	int32                PendingLatencyProbes;
+
+	// Friends roster
+	TArray<TSharedRef<FOnlineFriend>> Friends;
+	TMap<FString, int32>              FriendIndices;
+	TSet<FString>                     ChangedFriends;
+	double                            FriendsCacheTime;
+	bool                              FriendsRefreshing;
+
+	// Join tracking
+	FOnlineSessionSearchResult CurrentJoinResult;
+	FUniqueNetIdRepl           CurrentJoinFriendId;
+	bool                       FindingFriendSession;
+	double                     JoinStartTime;
+	FNeutronSessionStatistics  Statistics;
+
 	// Session created
 	FOnCreateSessionCompleteDelegate OnCreateSessionCompleteDelegate;
 	FDelegateHandle                  OnCreateSessionCompleteDelegateHandle;
@@ -247,14 +537,28 @@ private:
 	FOnDestroySessionCompleteDelegate OnDestroySessionCompleteDelegate;
 	FDelegateHandle                   OnDestroySessionCompleteDelegateHandle;
 
-	// Friend list has been read
+	// Session list has been read
 	FNeutronOnSessionSearchComplete OnSessionListReady;
 
+	// Session list has been partially read
+	FNeutronOnSessionSearchUpdate OnSessionListUpdated;
+
 	// Friend list is available
 	FOnReadFriendsListComplete OnReadFriendsListCompleteDelegate;
 
-	// Friend list has been read
-	FNeutronOnFriendSearchComplete OnFriendListReady;
+	// Friend list requests waiting for the roster
+	TArray<FNeutronOnFriendSearchComplete> PendingFriendSearches;
+
+	// Friend roster has changed
+	FNeutronOnFriendsUpdated OnFriendsUpdated;
+
+	// Friend presence has changed
+	FOnPresenceReceivedDelegate OnPresenceReceivedDelegate;
+	FDelegateHandle             OnPresenceReceivedDelegateHandle;
+
+	// Friend list has changed
+	FOnFriendsChangeDelegate OnFriendsChangeDelegate;
+	FDelegateHandle          OnFriendsChangeDelegateHandle;
 
 	// Friend invite accepted or joined manually
 	FNeutronOnFriendInviteAccepted OnFriendInviteAccepted;
@@ -283,6 +587,21 @@ public:
 		return LastNetworkError;
 	}
 
+	const TArray<FNeutronSessionTransition>& GetTransitionLog() const
+	{
+		return TransitionLog;
+	}
+
+	const FNeutronSessionStatistics& GetStatistics() const
+	{
+		return Statistics;
+	}
+
+	double GetFriendsCacheTime() const
+	{
+		return FriendsCacheTime;
+	}
+
 	FText GetNetworkStateString() const;
 
 	FText GetNetworkErrorString() const;
@@ -11,47 +11,95 @@
 #include "Neutron/Neutron.h"
 
 #include "Components/AudioComponent.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Sound/SoundClass.h"
 #include "AudioDevice.h"
 
 // Statics
 UNeutronSoundManager* UNeutronSoundManager::Singleton = nullptr;
 
+// Stats
+DECLARE_STATS_GROUP(TEXT("Neutron Sound"), STATGROUP_NeutronSound, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Tick"), STAT_NeutronSoundTick, STATGROUP_NeutronSound);
+DECLARE_CYCLE_STAT(TEXT("State callbacks"), STAT_NeutronSoundCallbacks, STATGROUP_NeutronSound);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sound updates"), STAT_NeutronSoundUpdates, STATGROUP_NeutronSound);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Environment sounds"), STAT_NeutronSoundInstances, STATGROUP_NeutronSound);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Voices in use"), STAT_NeutronSoundVoices, STATGROUP_NeutronSound);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Free voices"), STAT_NeutronSoundFreeVoices, STATGROUP_NeutronSound);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Music switches"), STAT_NeutronSoundMusicSwitches, STATGROUP_NeutronSound);
+
+// Console interface
+static TAutoConsoleVariable<int32> CVarNeutronSoundDebug(
+	TEXT("neutron.SoundDebug"), 0, TEXT("Show the state of Neutron sound voices, music and mixer on screen"));
+
 /*----------------------------------------------------
     Audio player instance
 ----------------------------------------------------*/
 
-FNeutronSoundInstance::FNeutronSoundInstance(
-	UObject* Owner, FNeutronSoundInstanceCallback Callback, USoundBase* Sound, bool ChangePitchWithFade, float FadeSpeed)
-	: StateCallback(Callback), SoundPitchFade(ChangePitchWithFade), SoundFadeSpeed(FadeSpeed), CurrentVolume(0.0f)
+static UAudioComponent* CreateSoundComponent(UObject* Owner)
 {
-	// Create the sound component
 	NCHECK(Owner);
-	SoundComponent = NewObject<UAudioComponent>(Owner, UAudioComponent::StaticClass());
+	UAudioComponent* SoundComponent = NewObject<UAudioComponent>(Owner, UAudioComponent::StaticClass());
 	NCHECK(SoundComponent);
 	SoundComponent->RegisterComponent();
 
-	// Set up the sound component
-	SoundComponent->Sound         = Sound;
 	SoundComponent->bAutoActivate = false;
 	SoundComponent->bAutoDestroy  = false;
+
+	return SoundComponent;
+}
+
+FNeutronSoundInstance::FNeutronSoundInstance(
+	UObject* Owner, FNeutronSoundInstanceCallback Callback, USoundBase* NewSound, bool ChangePitchWithFade, float FadeSpeed)
+	: FNeutronSoundInstance(Callback, NewSound, NAME_None, ChangePitchWithFade, FadeSpeed)
+{
+	SoundComponent        = CreateSoundComponent(Owner);
+	SoundComponent->Sound = NewSound;
 }
 
+FNeutronSoundInstance::FNeutronSoundInstance(
+	FNeutronSoundInstanceCallback Callback, USoundBase* NewSound, FName NewCategory, bool ChangePitchWithFade, float FadeSpeed)
+	: SoundComponent(nullptr)
+	, Sound(NewSound)
+	, Category(NewCategory)
+	, StateCallback(Callback)
+	, SoundPitchFade(ChangePitchWithFade)
+	, SoundFadeSpeed(FadeSpeed)
+	, CurrentVolume(0.0f)
+	, ShouldPlay(false)
+	, CallbackTime(0)
+	, LastUpdateTime(0)
+{}
+
 void FNeutronSoundInstance::Update(float DeltaTime)
 {
-	if (IsValid())
+	// Check the state
+	ShouldPlay   = false;
+	CallbackTime = 0;
+	if (StateCallback.IsBound())
 	{
-		// Check the state
-		bool ShouldPlay = false;
-		if (StateCallback.IsBound())
-		{
-			ShouldPlay = StateCallback.Execute();
-		}
+		SCOPE_CYCLE_COUNTER(STAT_NeutronSoundCallbacks);
+
+		double StartTime = FPlatformTime::Seconds();
+		ShouldPlay       = StateCallback.Execute();
+		CallbackTime     = FPlatformTime::Seconds() - StartTime;
+	}
+	INC_DWORD_STAT(STAT_NeutronSoundUpdates);
 
-		// Determine new volume
-		float VolumeDelta = (ShouldPlay ? 1.0f : -1.0f) * DeltaTime;
-		float NewVolume   = FMath::Clamp(CurrentVolume + VolumeDelta * SoundFadeSpeed, 0.0f, 1.0f);
+	// Determine new volume
+	float VolumeDelta = (ShouldPlay ? 1.0f : -1.0f) * DeltaTime;
+	float NewVolume   = FMath::Clamp(CurrentVolume + VolumeDelta * SoundFadeSpeed, 0.0f, 1.0f);
+
+	// Virtual sounds only track their volume
+	if (!IsValid())
+	{
+		CurrentVolume = NewVolume;
+	}
 
-		// Update playback
+	// Update playback
+	else
+	{
 		if (NewVolume != CurrentVolume)
 		{
 			if (CurrentVolume == 0 && NewVolume != 0)
@@ -79,12 +127,32 @@ void FNeutronSoundInstance::Update(float DeltaTime)
 	}
 }
 
-bool FNeutronSoundInstance::IsValid()
+void FNeutronSoundInstance::SetVoice(UAudioComponent* Component)
+{
+	if (Component)
+	{
+		Component->SetSound(Sound);
+		Component->SetVolumeMultiplier(CurrentVolume);
+		Component->SetPitchMultiplier(SoundPitchFade ? 0.5f + 0.5f * CurrentVolume : 1.0f);
+		if (CurrentVolume > 0)
+		{
+			Component->Play();
+		}
+	}
+	else if (IsValid())
+	{
+		SoundComponent->Stop();
+	}
+
+	SoundComponent = Component;
+}
+
+bool FNeutronSoundInstance::IsValid() const
 {
 	return ::IsValid(SoundComponent);
 }
 
-bool FNeutronSoundInstance::IsIdle()
+bool FNeutronSoundInstance::IsIdle() const
 {
 	return !IsValid() || !SoundComponent->IsPlaying();
 }
@@ -107,13 +175,22 @@ UNeutronSoundManager::UNeutronSoundManager()
 	, EffectsVolume(1.0f)
 	, EffectsVolumeMultiplier(1.0f)
 	, MusicVolume(1.0f)
+
+	, NextMusicSound(nullptr)
+	, CurrentMusicDeck(0)
+	, MusicTrackTime(0)
+	, NextMusicTrack(NAME_None)
+	, MusicPrefetchGeneration(0)
+
+	, VirtualUpdateIndex(0)
+	, EnvironmentTime(0)
 {}
 
 /*----------------------------------------------------
     Public methods
 ----------------------------------------------------*/
 
-void UNeutronSoundManager::BeginPlay(ANeutronPlayerController* PC, FNeutronMusicCallback Callback)
+void UNeutronSoundManager::BeginPlay(ANeutronPlayerController* PC, FNeutronMusicCallback Callback, const UNeutronSoundSetup* Setup)
 {
 	NLOG("UNeutronSoundManager::BeginPlay");
 
@@ -123,8 +200,8 @@ void UNeutronSoundManager::BeginPlay(ANeutronPlayerController* PC, FNeutronMusic
 
 	// Get basic game pointers
 	const UNeutronGameUserSettings* GameUserSettings = Cast<UNeutronGameUserSettings>(GEngine->GetGameUserSettings());
-	NCHECK(GameUserSettings);
-	SoundSetup = UNeutronAssetManager::Get()->GetDefaultAsset<UNeutronSoundSetup>();
+	SoundSetup = Setup ? Setup : UNeutronAssetManager::Get()->GetDefaultAsset<UNeutronSoundSetup>();
+	NCHECK(SoundSetup);
 
 	// Be safe
 	NCHECK(SoundSetup->MasterSoundMix);
@@ -135,70 +212,91 @@ void UNeutronSoundManager::BeginPlay(ANeutronPlayerController* PC, FNeutronMusic
 
 	// Fetch and map the musical tracks
 	MusicCatalog.Empty();
-	if (SoundSetup)
+	for (const FNeutronMusicCatalogEntry& Entry : SoundSetup->Tracks)
 	{
-		for (const FNeutronMusicCatalogEntry& Entry : SoundSetup->Tracks)
-		{
-			MusicCatalog.Add(Entry.Name, Entry.Tracks);
-		}
+		MusicCatalog.Add(Entry.Name, Entry.Tracks);
 	}
 
 	// Initialize the sound device and master mix
-	AudioDevice = PC->GetWorld()->GetAudioDevice();
+	AudioDevice = IsValid(PC) && PC->GetWorld() ? PC->GetWorld()->GetAudioDevice() : FAudioDeviceHandle();
+	AppliedMixVolumes.Empty();
+	PendingMixOverrides.Empty();
 	if (AudioDevice)
 	{
 		AudioDevice->SetBaseSoundMix(SoundSetup->MasterSoundMix);
 	}
 
-	// Setup sound settings
-	SetMasterVolume(GameUserSettings->MasterVolume);
-	SetUIVolume(GameUserSettings->UIVolume);
-	SetEffectsVolume(GameUserSettings->EffectsVolume);
-	SetMusicVolume(GameUserSettings->MusicVolume);
+	// Setup sound settings, at full volume when the game doesn't use Neutron settings
+	SetMasterVolume(GameUserSettings ? GameUserSettings->MasterVolume : 10);
+	SetUIVolume(GameUserSettings ? GameUserSettings->UIVolume : 10);
+	SetEffectsVolume(GameUserSettings ? GameUserSettings->EffectsVolume : 10);
+	SetMusicVolume(GameUserSettings ? GameUserSettings->MusicVolume : 10);
 
-	// Initialize the music instance
+	// Initialize the voice pool, owned by the player so that it follows the level, and left empty without one
 	EnvironmentSoundInstances.Empty();
-	MusicSoundInstance = FNeutronSoundInstance(PlayerController,    //
-		FNeutronSoundInstanceCallback::CreateLambda(
-			[this]()
+	VoicedSoundInstances.Empty();
+	CategoryVoiceCounts.Empty();
+	VoicePool.Empty();
+	VirtualUpdateIndex = 0;
+	EnvironmentTime    = 0;
+	if (IsValid(PlayerController))
+	{
+		for (int32 Index = 0; Index < SoundSetup->VoicePoolSize; Index++)
+		{
+			VoicePool.Add(CreateSoundComponent(PlayerController));
+		}
+	}
+
+	// Initialize the music decks, only the current one being audible, and virtual without a player
+	for (int32 DeckIndex = 0; DeckIndex < UE_ARRAY_COUNT(MusicDecks); DeckIndex++)
+	{
+		FNeutronSoundInstanceCallback DeckCallback = FNeutronSoundInstanceCallback::CreateLambda(
+			[this, DeckIndex]()
 			{
-				return CurrentMusicTrack == DesiredMusicTrack;
-			}),
-		nullptr, false, SoundSetup->MusicFadeSpeed);
+				return DeckIndex == CurrentMusicDeck;
+			});
+
+		if (IsValid(PlayerController))
+		{
+			MusicDecks[DeckIndex] = FNeutronSoundInstance(PlayerController, DeckCallback, nullptr, false, SoundSetup->MusicFadeSpeed);
+		}
+		else
+		{
+			MusicDecks[DeckIndex] = FNeutronSoundInstance(DeckCallback, nullptr, NAME_None, false, SoundSetup->MusicFadeSpeed);
+		}
+	}
+	CurrentMusicDeck  = 0;
+	CurrentMusicTrack = NAME_None;
+	NextMusicTrack    = NAME_None;
+	NextMusicSound    = nullptr;
+	MusicPrefetchGeneration++;
 }
 
 void UNeutronSoundManager::Mute()
 {
 	NLOG("UNeutronSoundManager::Mute");
 
-	if (AudioDevice)
-	{
-		AudioDevice->SetSoundMixClassOverride(
-			SoundSetup->MasterSoundMix, SoundSetup->MasterSoundClass, 0.0f, 1.0f, ENeutronUIConstants::FadeDurationShort, true);
-	}
+	SetMixOverride(SoundSetup->MasterSoundClass, 0.0f, ENeutronUIConstants::FadeDurationShort);
 }
 
 void UNeutronSoundManager::UnMute()
 {
 	NLOG("UNeutronSoundManager::UnMute");
 
-	if (AudioDevice)
-	{
-		AudioDevice->SetSoundMixClassOverride(
-			SoundSetup->MasterSoundMix, SoundSetup->MasterSoundClass, MasterVolume, 1.0f, ENeutronUIConstants::FadeDurationShort, true);
-	}
+	SetMixOverride(SoundSetup->MasterSoundClass, MasterVolume, ENeutronUIConstants::FadeDurationShort);
 }
 
 void UNeutronSoundManager::AddEnvironmentSound(
 	FName SoundName, FNeutronSoundInstanceCallback Callback, bool ChangePitchWithFade, float FadeSpeed)
 {
-	NCHECK(IsValid(PlayerController));
+	NCHECK(SoundSetup);
 
 	const FNeutronEnvironmentSoundEntry* EnvironmentSound = SoundSetup->Sounds.Find(SoundName);
 	if (EnvironmentSound)
 	{
-		EnvironmentSoundInstances.Add(FNeutronSoundInstance(
-			PlayerController, Callback, EnvironmentSound->Sound, EnvironmentSound->ChangePitchWithFade, EnvironmentSound->SoundFadeSpeed));
+		FNeutronSoundInstance& Sound = EnvironmentSoundInstances.Add_GetRef(FNeutronSoundInstance(Callback, EnvironmentSound->Sound,
+			EnvironmentSound->Category, EnvironmentSound->ChangePitchWithFade, EnvironmentSound->SoundFadeSpeed));
+		Sound.LastUpdateTime = EnvironmentTime;
 	}
 }
 
@@ -208,11 +306,7 @@ void UNeutronSoundManager::SetMasterVolume(int32 Volume)
 
 	MasterVolume = FMath::Clamp(Volume / 10.0f, 0.0f, 1.0f);
 
-	if (AudioDevice)
-	{
-		AudioDevice->SetSoundMixClassOverride(
-			SoundSetup->MasterSoundMix, SoundSetup->MasterSoundClass, MasterVolume, 1.0f, ENeutronUIConstants::FadeDurationLong, true);
-	}
+	SetMixOverride(SoundSetup->MasterSoundClass, MasterVolume, ENeutronUIConstants::FadeDurationLong);
 }
 
 void UNeutronSoundManager::SetUIVolume(int32 Volume)
@@ -221,11 +315,7 @@ void UNeutronSoundManager::SetUIVolume(int32 Volume)
 
 	UIVolume = FMath::Clamp(Volume / 10.0f, 0.0f, 1.0f);
 
-	if (AudioDevice)
-	{
-		AudioDevice->SetSoundMixClassOverride(
-			SoundSetup->MasterSoundMix, SoundSetup->UISoundClass, UIVolume, 1.0f, ENeutronUIConstants::FadeDurationLong, true);
-	}
+	SetMixOverride(SoundSetup->UISoundClass, UIVolume, ENeutronUIConstants::FadeDurationLong);
 }
 
 void UNeutronSoundManager::SetEffectsVolume(int32 Volume)
@@ -243,10 +333,258 @@ void UNeutronSoundManager::SetMusicVolume(int32 Volume)
 
 	MusicVolume = FMath::Clamp(Volume / 10.0f, 0.0f, 1.0f);
 
-	if (AudioDevice)
+	SetMixOverride(SoundSetup->MusicSoundClass, MusicVolume, ENeutronUIConstants::FadeDurationLong);
+}
+
+/*----------------------------------------------------
+    Internals
+----------------------------------------------------*/
+
+bool UNeutronSoundManager::AcquireVoice(FNeutronSoundInstance& Sound)
+{
+	const int32* Limit = SoundSetup->CategoryVoiceLimits.Find(Sound.Category);
+	int32&       Count = CategoryVoiceCounts.FindOrAdd(Sound.Category);
+
+	if (VoicePool.Num() == 0 || (Limit && Count >= *Limit))
+	{
+		Statistics.VoiceStarvations++;
+		return false;
+	}
+
+	Sound.SetVoice(VoicePool.Pop(false));
+	Count++;
+
+	return true;
+}
+
+void UNeutronSoundManager::ReleaseVoice(FNeutronSoundInstance& Sound)
+{
+	VoicePool.Add(Sound.SoundComponent);
+	Sound.SetVoice(nullptr);
+	CategoryVoiceCounts.FindOrAdd(Sound.Category)--;
+}
+
+void UNeutronSoundManager::UpdateEnvironmentSounds(float DeltaTime)
+{
+	EnvironmentTime += DeltaTime;
+
+	// Update playing sounds every frame, and release the voices of those that faded out
+	for (int32 Index = VoicedSoundInstances.Num() - 1; Index >= 0; Index--)
+	{
+		FNeutronSoundInstance& Sound = EnvironmentSoundInstances[VoicedSoundInstances[Index]];
+
+		Sound.Update(static_cast<float>(EnvironmentTime - Sound.LastUpdateTime));
+		Sound.LastUpdateTime = EnvironmentTime;
+		Statistics.CallbackTime += Sound.CallbackTime;
+		if (!Sound.IsAudible())
+		{
+			ReleaseVoice(Sound);
+			VoicedSoundInstances.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	// Check a bounded number of virtual sounds per frame, fading them by the time elapsed since their last check
+	const int32 UpdateCount = FMath::Min(SoundSetup->VirtualUpdateBudget, EnvironmentSoundInstances.Num());
+	for (int32 Step = 0; Step < UpdateCount; Step++)
+	{
+		VirtualUpdateIndex           = (VirtualUpdateIndex + 1) % EnvironmentSoundInstances.Num();
+		FNeutronSoundInstance& Sound = EnvironmentSoundInstances[VirtualUpdateIndex];
+
+		if (!Sound.IsValid())
+		{
+			Sound.Update(static_cast<float>(EnvironmentTime - Sound.LastUpdateTime));
+			Sound.LastUpdateTime = EnvironmentTime;
+			Statistics.CallbackTime += Sound.CallbackTime;
+			if (Sound.IsAudible() && AcquireVoice(Sound))
+			{
+				VoicedSoundInstances.Add(VirtualUpdateIndex);
+			}
+		}
+	}
+}
+
+void UNeutronSoundManager::SetMixOverride(USoundClass* SoundClass, float Volume, float FadeTime)
+{
+	constexpr float MixVolumeTolerance = 0.001f;
+
+	const float* AppliedVolume = AppliedMixVolumes.Find(SoundClass);
+	if (AppliedVolume == nullptr || !FMath::IsNearlyEqual(*AppliedVolume, Volume, MixVolumeTolerance))
+	{
+		AppliedMixVolumes.Add(SoundClass, Volume);
+		PendingMixOverrides.Add(SoundClass, FNeutronSoundMixOverride(Volume, FadeTime));
+	}
+}
+
+void UNeutronSoundManager::FlushMixOverrides()
+{
+	if (MixSink.IsBound())
+	{
+		for (const TPair<USoundClass*, FNeutronSoundMixOverride>& Override : PendingMixOverrides)
+		{
+			MixSink.Execute(Override.Key, Override.Value.Volume, Override.Value.FadeTime);
+		}
+	}
+	else if (AudioDevice)
+	{
+		// The audio device marshals the overrides to the audio thread itself
+		for (const TPair<USoundClass*, FNeutronSoundMixOverride>& Override : PendingMixOverrides)
+		{
+			AudioDevice->SetSoundMixClassOverride(
+				SoundSetup->MasterSoundMix, Override.Key, Override.Value.Volume, 1.0f, Override.Value.FadeTime, true);
+		}
+	}
+
+	PendingMixOverrides.Empty();
+}
+
+int32 UNeutronSoundManager::GetNextMusicTrackIndex(FName Track)
+{
+	TArray<int32>& Bag = MusicShuffleBags.FindOrAdd(Track);
+
+	// Refill the bag with a new permutation, without repeating the last track across bags
+	if (Bag.Num() == 0)
+	{
+		for (int32 Index = 0; Index < MusicCatalog[Track].Num(); Index++)
+		{
+			Bag.Add(Index);
+		}
+
+		for (int32 Index = Bag.Num() - 1; Index > 0; Index--)
+		{
+			Bag.Swap(Index, FMath::RandRange(0, Index));
+		}
+
+		const int32* LastIndex = LastMusicTrackIndices.Find(Track);
+		if (LastIndex && Bag.Num() > 1 && Bag.Last() == *LastIndex)
+		{
+			Bag.Swap(0, Bag.Num() - 1);
+		}
+	}
+
+	int32 TrackIndex = Bag.Pop(false);
+	LastMusicTrackIndices.Add(Track, TrackIndex);
+
+	return TrackIndex;
+}
+
+void UNeutronSoundManager::PrefetchMusic(FName Track)
+{
+	const TArray<TSoftObjectPtr<USoundBase>>* Tracks = MusicCatalog.Find(Track);
+	if (Tracks == nullptr || Tracks->Num() == 0)
+	{
+		return;
+	}
+
+	int32                      TrackIndex = GetNextMusicTrackIndex(Track);
+	TSoftObjectPtr<USoundBase> Sound      = (*Tracks)[TrackIndex];
+	uint32                     Generation = ++MusicPrefetchGeneration;
+
+	NLOG("UNeutronSoundManager::PrefetchMusic : '%s' %d", *Track.ToString(), TrackIndex);
+
+	NextMusicTrack = Track;
+	NextMusicSound = nullptr;
+
+	// Tracks still in memory don't need streaming
+	if (Sound.IsValid())
+	{
+		NextMusicSound = Sound.Get();
+		return;
+	}
+
+	// Ignore loads that completed after another prefetch was started
+	FStreamableDelegate Callback = FStreamableDelegate::CreateLambda(
+		[this, Sound, Generation]()
+		{
+			if (Generation == MusicPrefetchGeneration)
+			{
+				NextMusicSound = Sound.Get();
+			}
+		});
+	UNeutronAssetManager::Get()->LoadAsset(Sound.ToSoftObjectPath(), Callback, true);
+}
+
+void UNeutronSoundManager::StartNextMusicTrack()
+{
+	NLOG("UNeutronSoundManager::StartNextMusicTrack : switching track from '%s' to '%s'", *CurrentMusicTrack.ToString(),
+		*NextMusicTrack.ToString());
+
+	// Swap decks, letting the previous one fade out
+	CurrentMusicDeck                = 1 - CurrentMusicDeck;
+	FNeutronSoundInstance& NextDeck = MusicDecks[CurrentMusicDeck];
+	NextDeck.Sound                  = NextMusicSound;
+	if (NextDeck.IsValid())
 	{
-		AudioDevice->SetSoundMixClassOverride(
-			SoundSetup->MasterSoundMix, SoundSetup->MusicSoundClass, MusicVolume, 1.0f, ENeutronUIConstants::FadeDurationLong, true);
+		NextDeck.SoundComponent->SetSound(NextMusicSound);
+	}
+
+	CurrentMusicTrack = NextMusicTrack;
+	MusicTrackTime    = 0;
+	Statistics.MusicSwitches++;
+	INC_DWORD_STAT(STAT_NeutronSoundMusicSwitches);
+
+	// Start streaming the following track right away
+	PrefetchMusic(CurrentMusicTrack);
+}
+
+void UNeutronSoundManager::DrawDebugOverlay() const
+{
+	uint64 Key          = static_cast<uint64>(GetUniqueID()) << 8;
+	auto   AddDebugLine = [&Key](const FString& Text, const FColor& Color = FColor::White)
+	{
+		GEngine->AddOnScreenDebugMessage(Key++, 0.0f, Color, Text);
+	};
+
+	// Voices
+	AddDebugLine(FString::Printf(TEXT("Sound : %d environment sounds, %d/%d voices in use, %d starvations, callbacks %.3fms (peak %.3fms)"),
+		EnvironmentSoundInstances.Num(), VoicedSoundInstances.Num(), VoicedSoundInstances.Num() + VoicePool.Num(),
+		Statistics.VoiceStarvations, Statistics.CallbackTime * 1000.0, Statistics.PeakCallbackTime * 1000.0));
+
+	// Voices per category : active ones have a voice, virtual ones are audible without one, idle ones are silent
+	TMap<FName, FIntVector> Categories;
+	for (const FNeutronSoundInstance& Sound : EnvironmentSoundInstances)
+	{
+		FIntVector& Counts = Categories.FindOrAdd(Sound.Category, FIntVector::ZeroValue);
+		if (Sound.IsValid())
+		{
+			Counts.X++;
+		}
+		else if (Sound.IsAudible())
+		{
+			Counts.Y++;
+		}
+		else
+		{
+			Counts.Z++;
+		}
+	}
+	for (const TPair<FName, FIntVector>& Category : Categories)
+	{
+		const int32* Limit = SoundSetup->CategoryVoiceLimits.Find(Category.Key);
+		AddDebugLine(FString::Printf(TEXT("    '%s' : %d active, %d virtual, %d idle, limit %d"), *Category.Key.ToString(),
+			Category.Value.X, Category.Value.Y, Category.Value.Z, Limit ? *Limit : -1));
+	}
+
+	// Music
+	for (int32 DeckIndex = 0; DeckIndex < UE_ARRAY_COUNT(MusicDecks); DeckIndex++)
+	{
+		const FNeutronSoundInstance& Deck    = MusicDecks[DeckIndex];
+		const TCHAR*                 Current = DeckIndex == CurrentMusicDeck ? TEXT(" (current)") : TEXT("");
+		const TCHAR*                 Idle    = Deck.IsIdle() ? TEXT(", idle") : TEXT("");
+
+		AddDebugLine(FString::Printf(TEXT("Music deck %d%s : '%s' at %.2f%s"), DeckIndex, Current, *GetNameSafe(Deck.Sound),
+						 Deck.CurrentVolume, Idle),
+			FColor::Cyan);
+	}
+
+	const TCHAR* NextState = NextMusicSound ? TEXT("ready") : TEXT("streaming");
+	AddDebugLine(FString::Printf(TEXT("Music : '%s' for %.1fs, next '%s' %s, %d switches"), *CurrentMusicTrack.ToString(), MusicTrackTime,
+					 *NextMusicTrack.ToString(), NextState, Statistics.MusicSwitches),
+		FColor::Cyan);
+
+	// Mixer
+	for (const TPair<USoundClass*, float>& Override : AppliedMixVolumes)
+	{
+		AddDebugLine(FString::Printf(TEXT("Mix '%s' : %.2f"), *GetNameSafe(Override.Key), Override.Value), FColor::Yellow);
 	}
 }
 
@@ -256,37 +594,54 @@ void UNeutronSoundManager::SetMusicVolume(int32 Volume)
 
 void UNeutronSoundManager::Tick(float DeltaTime)
 {
-	// Control the music track
-	if (MusicSoundInstance.IsValid() && MasterVolume > 0)
+	SCOPE_CYCLE_COUNTER(STAT_NeutronSoundTick);
+
+	Statistics.CallbackTime = 0;
+
+	// Control the music track, with virtual decks following the same fades when headless
+	if (SoundSetup && MasterVolume > 0)
 	{
 		DesiredMusicTrack = MusicCallback.IsBound() ? MusicCallback.Execute() : NAME_None;
+		MusicTrackTime += DeltaTime;
 
-		if (CurrentMusicTrack != DesiredMusicTrack || MusicSoundInstance.IsIdle())
-		{
-			int32 TrackIndex = FMath::RandHelper(MusicCatalog[DesiredMusicTrack].Num());
-
-			NLOG("UNeutronSoundManager::Tick : switching track from '%s' to '%s' %d", *CurrentMusicTrack.ToString(),
-				*DesiredMusicTrack.ToString(), TrackIndex);
+		// Start crossfading before the end of the current track, virtual decks never stop on their own
+		const FNeutronSoundInstance& CurrentDeck  = MusicDecks[CurrentMusicDeck];
+		const float                  FadeTime     = 1.0f / SoundSetup->MusicFadeSpeed;
+		const bool                   TrackStopped = CurrentDeck.IsValid() && CurrentDeck.IsIdle();
+		const bool TrackEnding = TrackStopped || (CurrentDeck.Sound && MusicTrackTime > CurrentDeck.Sound->Duration - FadeTime);
 
-			MusicSoundInstance.SoundComponent->SetSound(MusicCatalog[DesiredMusicTrack][TrackIndex]);
-			CurrentMusicTrack = DesiredMusicTrack;
+		// Switch once the next track has been streamed in, keeping the current one playing meanwhile
+		if (CurrentMusicTrack != DesiredMusicTrack || TrackEnding)
+		{
+			if (NextMusicTrack != DesiredMusicTrack)
+			{
+				PrefetchMusic(DesiredMusicTrack);
+			}
+			else if (NextMusicSound)
+			{
+				StartNextMusicTrack();
+			}
 		}
 
-		MusicSoundInstance.Update(DeltaTime);
+		for (FNeutronSoundInstance& Deck : MusicDecks)
+		{
+			Deck.Update(DeltaTime);
+			Statistics.CallbackTime += Deck.CallbackTime;
+		}
 	}
 
-	// Update all sound instances
-	for (FNeutronSoundInstance& Sound : EnvironmentSoundInstances)
+	// Update environment sounds
+	if (SoundSetup)
 	{
-		Sound.Update(DeltaTime);
+		UpdateEnvironmentSounds(DeltaTime);
 	}
 
-	// Check if we should fade out audio effects
-	if (AudioDevice)
+	// Check if we should fade out audio effects, menus only being displayed to a player
+	if (SoundSetup && (AudioDevice || MixSink.IsBound()))
 	{
-		UNeutronMenuManager* MenuManager = UNeutronMenuManager::Get();
+		const UNeutronMenuManager* MenuManager = IsValid(PlayerController) ? UNeutronMenuManager::Get() : nullptr;
 
-		if (MenuManager->IsMenuOpening() && SoundSetup->FadeEffectsInMenus)
+		if (SoundSetup->FadeEffectsInMenus && MenuManager && MenuManager->IsMenuOpening())
 		{
 			EffectsVolumeMultiplier -= DeltaTime / ENeutronUIConstants::FadeDurationShort;
 		}
@@ -296,7 +651,22 @@ void UNeutronSoundManager::Tick(float DeltaTime)
 		}
 		EffectsVolumeMultiplier = FMath::Clamp(EffectsVolumeMultiplier, 0.01f, 1.0f);
 
-		AudioDevice->SetSoundMixClassOverride(
-			SoundSetup->MasterSoundMix, SoundSetup->EffectsSoundClass, EffectsVolumeMultiplier * EffectsVolume, 1.0f, 0.0f, true);
+		SetMixOverride(SoundSetup->EffectsSoundClass, EffectsVolumeMultiplier * EffectsVolume, 0.0f);
+	}
+
+	// Apply all mixer changes at once
+	FlushMixOverrides();
+
+	// Instrumentation
+	Statistics.PeakCallbackTime = FMath::Max(Statistics.PeakCallbackTime, Statistics.CallbackTime);
+	SET_DWORD_STAT(STAT_NeutronSoundInstances, EnvironmentSoundInstances.Num());
+	SET_DWORD_STAT(STAT_NeutronSoundVoices, VoicedSoundInstances.Num());
+	SET_DWORD_STAT(STAT_NeutronSoundFreeVoices, VoicePool.Num());
+
+#if !UE_BUILD_SHIPPING
+	if (CVarNeutronSoundDebug.GetValueOnGameThread() && SoundSetup && GEngine)
+	{
+		DrawDebugOverlay();
 	}
+#endif
 }
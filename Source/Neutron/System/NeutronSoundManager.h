@@ -27,9 +27,9 @@ struct FNeutronMusicCatalogEntry
 	UPROPERTY(Category = Sound, EditDefaultsOnly)
 	FName Name;
 
-	/** Sound asset */
+	/** Sound assets, streamed in before being played */
 	UPROPERTY(Category = Sound, EditDefaultsOnly)
-	TArray<class USoundBase*> Tracks;
+	TArray<TSoftObjectPtr<class USoundBase>> Tracks;
 };
 
 // Environment sound entry
@@ -38,13 +38,17 @@ struct FNeutronEnvironmentSoundEntry
 {
 	GENERATED_BODY()
 
-	FNeutronEnvironmentSoundEntry() : Sound(nullptr), ChangePitchWithFade(true), SoundFadeSpeed(1.0f)
+	FNeutronEnvironmentSoundEntry() : Sound(nullptr), Category(NAME_None), ChangePitchWithFade(true), SoundFadeSpeed(1.0f)
 	{}
 
 	/** Sound asset */
 	UPROPERTY(Category = Sound, EditDefaultsOnly)
 	class USoundBase* Sound;
 
+	/** Sound category for concurrency limits */
+	UPROPERTY(Category = Sound, EditDefaultsOnly)
+	FName Category;
+
 	/** Whether to fade the pitch */
 	UPROPERTY(Category = Sound, EditDefaultsOnly)
 	bool ChangePitchWithFade;
@@ -64,6 +68,8 @@ public:
 
 	UNeutronSoundSetup()
 		: MusicFadeSpeed(2.0f)
+		, VoicePoolSize(16)
+		, VirtualUpdateBudget(8)
 		, FadeEffectsInMenus(false)
 		, MasterSoundMix(nullptr)
 		, MasterSoundClass(nullptr)
@@ -86,6 +92,18 @@ public:
 	UPROPERTY(Category = Environment, EditDefaultsOnly)
 	TMap<FName, FNeutronEnvironmentSoundEntry> Sounds;
 
+	// Number of audio components shared by all environment sounds
+	UPROPERTY(Category = Environment, EditDefaultsOnly)
+	int32 VoicePoolSize;
+
+	// Maximum number of voices per sound category, unlimited if absent
+	UPROPERTY(Category = Environment, EditDefaultsOnly)
+	TMap<FName, int32> CategoryVoiceLimits;
+
+	// Number of silent environment sounds checked per frame
+	UPROPERTY(Category = Environment, EditDefaultsOnly)
+	int32 VirtualUpdateBudget;
+
 	// Fade out effect sounds in menus
 	UPROPERTY(Category = Environment, EditDefaultsOnly)
 	bool FadeEffectsInMenus;
@@ -126,27 +144,58 @@ struct FNeutronSoundInstance
 
 public:
 
-	FNeutronSoundInstance() : SoundComponent(nullptr), StateCallback(), SoundPitchFade(false), SoundFadeSpeed(0.0f), CurrentVolume(0.0f)
+	FNeutronSoundInstance()
+		: SoundComponent(nullptr)
+		, Sound(nullptr)
+		, Category(NAME_None)
+		, StateCallback()
+		, SoundPitchFade(false)
+		, SoundFadeSpeed(0.0f)
+		, CurrentVolume(0.0f)
+		, ShouldPlay(false)
+		, CallbackTime(0)
+		, LastUpdateTime(0)
 	{}
 
-	FNeutronSoundInstance(UObject* Owner, FNeutronSoundInstanceCallback Callback, class USoundBase* Sound = nullptr,
+	/** Create a sound with its own dedicated component */
+	FNeutronSoundInstance(UObject* Owner, FNeutronSoundInstanceCallback Callback, class USoundBase* NewSound = nullptr,
+		bool ChangePitchWithFade = false, float FadeSpeed = 1.0f);
+
+	/** Create a virtual sound that needs to be assigned a pooled component to play */
+	FNeutronSoundInstance(FNeutronSoundInstanceCallback Callback, class USoundBase* NewSound, FName NewCategory,
 		bool ChangePitchWithFade = false, float FadeSpeed = 1.0f);
 
 	/** Tick */
 	void Update(float DeltaTime);
 
+	/** Assign a pooled component to play on, or release it with nullptr */
+	void SetVoice(class UAudioComponent* Component);
+
 	/** Check if the sound was set up correctly */
-	bool IsValid();
+	bool IsValid() const;
 
 	/** Check if the sound has stopped */
-	bool IsIdle();
+	bool IsIdle() const;
+
+	/** Check if the sound is playing or should be */
+	bool IsAudible() const
+	{
+		return ShouldPlay || CurrentVolume > 0;
+	}
 
 public:
 
-	/** Sound component */
+	/** Sound component, owned or pooled */
 	UPROPERTY()
 	class UAudioComponent* SoundComponent;
 
+	/** Sound asset */
+	UPROPERTY()
+	class USoundBase* Sound;
+
+	/** Sound category */
+	FName Category;
+
 	/** Callback to check the player state */
 	FNeutronSoundInstanceCallback StateCallback;
 
@@ -158,6 +207,43 @@ public:
 
 	/** Volume */
 	float CurrentVolume;
+
+	/** Last state returned by the callback */
+	bool ShouldPlay;
+
+	/** Time spent in the callback on the last update, in seconds */
+	double CallbackTime;
+
+	/** Environment time of the last update, in seconds */
+	double LastUpdateTime;
+};
+
+/** Sound manager statistics */
+struct FNeutronSoundStatistics
+{
+	FNeutronSoundStatistics() : MusicSwitches(0), VoiceStarvations(0), CallbackTime(0), PeakCallbackTime(0)
+	{}
+
+	int32  MusicSwitches;
+	int32  VoiceStarvations;
+	double CallbackTime;
+	double PeakCallbackTime;
+};
+
+// Mixer replacement receiving the volume overrides for a sound class, with their fade time
+DECLARE_DELEGATE_ThreeParams(FNeutronSoundMixSink, class USoundClass*, float, float);
+
+/** Volume override for a sound class */
+struct FNeutronSoundMixOverride
+{
+	FNeutronSoundMixOverride() : Volume(1.0f), FadeTime(0.0f)
+	{}
+
+	FNeutronSoundMixOverride(float NewVolume, float NewFadeTime) : Volume(NewVolume), FadeTime(NewFadeTime)
+	{}
+
+	float Volume;
+	float FadeTime;
 };
 
 /*----------------------------------------------------
@@ -192,8 +278,8 @@ public:
 		Singleton = this;
 	}
 
-	/** Start playing on a new level */
-	void BeginPlay(class ANeutronPlayerController* PC, FNeutronMusicCallback Callback);
+	/** Start playing on a new level, without a player the manager runs headless with virtual sounds only */
+	void BeginPlay(class ANeutronPlayerController* PC, FNeutronMusicCallback Callback, const UNeutronSoundSetup* Setup = nullptr);
 
 	/*----------------------------------------------------
 	    Public methods
@@ -221,10 +307,76 @@ public:
 	/** Set the music volume from 0 to 10 */
 	void SetMusicVolume(int32 Volume);
 
+	/** Get the sound statistics */
+	const FNeutronSoundStatistics& GetStatistics() const
+	{
+		return Statistics;
+	}
+
+	/** Send volume overrides to a custom sink instead of the audio device, to run without audio */
+	void SetMixSink(FNeutronSoundMixSink Sink)
+	{
+		MixSink = Sink;
+	}
+
+	/** Get the last volume requested for a sound class */
+	float GetMixVolume(const class USoundClass* SoundClass) const
+	{
+		const float* Volume = AppliedMixVolumes.Find(SoundClass);
+		return Volume ? *Volume : 1.0f;
+	}
+
+	/** Get the music track being played */
+	FName GetCurrentMusicTrack() const
+	{
+		return CurrentMusicTrack;
+	}
+
+	/** Get the fade volume of the music deck playing the current track, or of the one fading out */
+	float GetMusicDeckVolume(bool CurrentDeck) const
+	{
+		return MusicDecks[CurrentDeck ? CurrentMusicDeck : 1 - CurrentMusicDeck].CurrentVolume;
+	}
+
+	/*----------------------------------------------------
+	    Internals
+	----------------------------------------------------*/
+
+protected:
+
+	/** Give a pooled voice to an environment sound, within the category limits */
+	bool AcquireVoice(FNeutronSoundInstance& Sound);
+
+	/** Return the voice of an environment sound to the pool */
+	void ReleaseVoice(FNeutronSoundInstance& Sound);
+
+	/** Update environment sounds, every frame for those playing, within the virtual budget for others */
+	void UpdateEnvironmentSounds(float DeltaTime);
+
+	/** Request a volume override for a sound class, ignored if the volume didn't change */
+	void SetMixOverride(class USoundClass* SoundClass, float Volume, float FadeTime);
+
+	/** Send all mix overrides requested this frame to the audio device or mix sink */
+	void FlushMixOverrides();
+
+	/** Pick the next track for a music entry from its shuffle bag */
+	int32 GetNextMusicTrackIndex(FName Track);
+
+	/** Start streaming the next track for a music entry */
+	void PrefetchMusic(FName Track);
+
+	/** Crossfade to the prefetched track on the other deck */
+	void StartNextMusicTrack();
+
+	/** Show voices, music and mixer state on screen */
+	void DrawDebugOverlay() const;
+
 	/*----------------------------------------------------
 	    Tick
 	----------------------------------------------------*/
 
+public:
+
 	virtual void              Tick(float DeltaTime) override;
 	virtual ETickableTickType GetTickableTickType() const override
 	{
@@ -261,11 +413,11 @@ private:
 	const UNeutronSoundSetup* SoundSetup;
 
 	// General state
-	FAudioDeviceHandle                     AudioDevice;
-	TMap<FName, TArray<class USoundBase*>> MusicCatalog;
-	FNeutronMusicCallback                  MusicCallback;
-	FName                                  CurrentMusicTrack;
-	FName                                  DesiredMusicTrack;
+	FAudioDeviceHandle                                    AudioDevice;
+	TMap<FName, TArray<TSoftObjectPtr<class USoundBase>>> MusicCatalog;
+	FNeutronMusicCallback                                 MusicCallback;
+	FName                                                 CurrentMusicTrack;
+	FName                                                 DesiredMusicTrack;
 
 	// Volume
 	float MasterVolume;
@@ -274,11 +426,41 @@ private:
 	float EffectsVolumeMultiplier;
 	float MusicVolume;
 
-	// Dedicated music player instance
+	// Music decks, crossfading into each other
+	UPROPERTY()
+	FNeutronSoundInstance MusicDecks[2];
+
+	// Prefetched music track
 	UPROPERTY()
-	FNeutronSoundInstance MusicSoundInstance;
+	class USoundBase* NextMusicSound;
+
+	// Music state
+	int32                      CurrentMusicDeck;
+	float                      MusicTrackTime;
+	FName                      NextMusicTrack;
+	uint32                     MusicPrefetchGeneration;
+	TMap<FName, TArray<int32>> MusicShuffleBags;
+	TMap<FName, int32>         LastMusicTrackIndices;
 
 	// Environment player instances
 	UPROPERTY()
 	TArray<FNeutronSoundInstance> EnvironmentSoundInstances;
+
+	// Free pooled voices
+	UPROPERTY()
+	TArray<class UAudioComponent*> VoicePool;
+
+	// Mixer state
+	TMap<class USoundClass*, float>                    AppliedMixVolumes;
+	TMap<class USoundClass*, FNeutronSoundMixOverride> PendingMixOverrides;
+	FNeutronSoundMixSink                               MixSink;
+
+	// Voice tracking
+	TArray<int32>      VoicedSoundInstances;
+	TMap<FName, int32> CategoryVoiceCounts;
+	int32              VirtualUpdateIndex;
+	double             EnvironmentTime;
+
+	// Instrumentation
+	FNeutronSoundStatistics Statistics;
 };
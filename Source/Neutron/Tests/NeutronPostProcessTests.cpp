@@ -0,0 +1,210 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronTests.h"
+#include "Neutron/System/NeutronPostProcessManager.h"
+#include "Neutron/UI/NeutronUI.h"
+#include "Neutron/Neutron.h"
+
+#include "Components/PostProcessComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Post-process update"), STAT_NeutronBenchmarkPostProcess, STATGROUP_NeutronBenchmarks);
+
+/*----------------------------------------------------
+    Test setup
+----------------------------------------------------*/
+
+// Preset with a single blended value
+struct FNeutronTestPostProcessSetting : public FNeutronPostProcessSettingBase
+{
+	FNeutronTestPostProcessSetting(float NewValue) : Value(NewValue)
+	{
+		TransitionDuration = 1.0f;
+	}
+
+	virtual void GetBlendValues(TArray<float>& Values) const override
+	{
+		Values.Add(Value);
+	}
+
+	float Value;
+};
+
+// Post-process manager running on a transient component, with a scripted target preset
+struct FNeutronTestPostProcessRig
+{
+	FNeutronTestPostProcessRig() : TargetPreset(0), LegacyValue(0)
+	{
+		Manager = NewObject<UNeutronPostProcessManager>(GetTransientPackage());
+		Manager->RegisterPreset(0, MakeShared<FNeutronTestPostProcessSetting>(0.0f));
+		Manager->RegisterPreset(1, MakeShared<FNeutronTestPostProcessSetting>(1.0f));
+		Manager->RegisterPreset(2, MakeShared<FNeutronTestPostProcessSetting>(-1.0f));
+
+		Manager->BeginPlay(nullptr,    //
+			FNeutronPostProcessControl::CreateLambda(
+				[this]()
+				{
+					return TargetPreset;
+				}),
+			FNeutronPostProcessUpdate::CreateLambda(
+				[this](UPostProcessComponent* Volume, TArray<UMaterialInstanceDynamic*> Materials,
+					const TSharedPtr<FNeutronPostProcessSettingBase>& Current, const TSharedPtr<FNeutronPostProcessSettingBase>& Target,
+					float Alpha)
+				{
+					LegacyValue = FMath::Lerp(static_cast<const FNeutronTestPostProcessSetting*>(Current.Get())->Value,
+						static_cast<const FNeutronTestPostProcessSetting*>(Target.Get())->Value, Alpha);
+				}));
+
+		Manager->SetPostProcessComponent(NewObject<UPostProcessComponent>(GetTransientPackage()));
+	}
+
+	~FNeutronTestPostProcessRig()
+	{
+		// The manager may still be ticked by the engine until it is collected
+		Manager->BeginPlay(nullptr, FNeutronPostProcessControl(), FNeutronPostProcessUpdate());
+		Manager->SetPostProcessComponent(nullptr);
+	}
+
+	/** Get the value blended from snapshots */
+	float GetValue() const
+	{
+		return Manager->GetBlendedValues().Num() ? Manager->GetBlendedValues()[0] : 0.0f;
+	}
+
+	UNeutronPostProcessManager* Manager;
+	int32                       TargetPreset;
+	float                       LegacyValue;
+};
+
+/*----------------------------------------------------
+    Tests
+----------------------------------------------------*/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronPostProcessBlendTest, "Neutron.PostProcess.Blend",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNeutronPostProcessBlendTest::RunTest(const FString& Parameters)
+{
+	FNeutronTestPostProcessRig Rig;
+
+	Rig.Manager->Tick(0.0f);
+	TestEqual(TEXT("Neutral preset is applied first"), Rig.GetValue(), 0.0f);
+
+	// Blend toward the first preset over its transition duration, with the standard easing
+	Rig.TargetPreset    = 1;
+	float PreviousValue = Rig.GetValue();
+	for (int32 Step = 1; Step <= 4; Step++)
+	{
+		Rig.Manager->Tick(0.25f);
+
+		const float ExpectedValue = FMath::InterpEaseInOut(0.0f, 1.0f, Step * 0.25f, ENeutronUIConstants::EaseStandard);
+		TestEqual(FString::Printf(TEXT("Blend follows the easing at step %d"), Step), Rig.GetValue(), ExpectedValue, 0.01f);
+		TestTrue(FString::Printf(TEXT("Blend is monotonic at step %d"), Step), Rig.GetValue() >= PreviousValue);
+		TestEqual(FString::Printf(TEXT("Legacy update matches the blend at step %d"), Step), Rig.LegacyValue, Rig.GetValue(), 0.01f);
+
+		PreviousValue = Rig.GetValue();
+	}
+
+	TestEqual(TEXT("Faded out presets are released"), Rig.Manager->GetLayers().Num(), 1);
+	TestEqual(TEXT("Target preset is fully applied"), Rig.GetValue(), 1.0f, KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronPostProcessRetargetTest, "Neutron.PostProcess.Retarget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNeutronPostProcessRetargetTest::RunTest(const FString& Parameters)
+{
+	constexpr float DeltaTime = 0.05f;
+	constexpr float MaxStep   = 0.3f;
+
+	FNeutronTestPostProcessRig Rig;
+	Rig.Manager->Tick(0.0f);
+
+	// Reverse the transition halfway through, the blend and the legacy update should resume from where they are
+	Rig.TargetPreset = 1;
+	for (int32 Step = 0; Step < 10; Step++)
+	{
+		Rig.Manager->Tick(DeltaTime);
+	}
+
+	float PreviousValue  = Rig.GetValue();
+	float PreviousLegacy = Rig.LegacyValue;
+	Rig.TargetPreset     = 0;
+	for (int32 Step = 0; Step < 30; Step++)
+	{
+		Rig.Manager->Tick(DeltaTime);
+
+		TestTrue(
+			FString::Printf(TEXT("Reversed blend is continuous at step %d"), Step), FMath::Abs(Rig.GetValue() - PreviousValue) < MaxStep);
+		TestTrue(FString::Printf(TEXT("Reversed legacy update is continuous at step %d"), Step),
+			FMath::Abs(Rig.LegacyValue - PreviousLegacy) < MaxStep);
+
+		PreviousValue  = Rig.GetValue();
+		PreviousLegacy = Rig.LegacyValue;
+	}
+	TestEqual(TEXT("Reversed blend returns to neutral"), Rig.GetValue(), 0.0f, KINDA_SMALL_NUMBER);
+
+	// Switch between two presets once settled, going through their mix rather than through neutral
+	Rig.TargetPreset = 1;
+	for (int32 Step = 0; Step < 30; Step++)
+	{
+		Rig.Manager->Tick(DeltaTime);
+	}
+
+	PreviousValue    = Rig.GetValue();
+	PreviousLegacy   = Rig.LegacyValue;
+	Rig.TargetPreset = 2;
+	for (int32 Step = 0; Step < 30; Step++)
+	{
+		Rig.Manager->Tick(DeltaTime);
+
+		TestTrue(
+			FString::Printf(TEXT("Switched blend is continuous at step %d"), Step), FMath::Abs(Rig.GetValue() - PreviousValue) < MaxStep);
+		TestTrue(FString::Printf(TEXT("Switched legacy update is continuous at step %d"), Step),
+			FMath::Abs(Rig.LegacyValue - PreviousLegacy) < MaxStep);
+
+		PreviousValue  = Rig.GetValue();
+		PreviousLegacy = Rig.LegacyValue;
+	}
+	TestEqual(TEXT("Switched blend reaches the new preset"), Rig.GetValue(), -1.0f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Switched legacy update reaches the new preset"), Rig.LegacyValue, -1.0f, KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+/*----------------------------------------------------
+    Benchmarks
+----------------------------------------------------*/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronPostProcessBenchmark, "Neutron.Benchmarks.PostProcess",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNeutronPostProcessBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 IterationCount = 10000;
+
+	FNeutronTestPostProcessRig Rig;
+
+	// Keep the presets transitioning so that every tick blends
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < IterationCount; Iteration++)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NeutronBenchmarkPostProcess);
+
+		Rig.TargetPreset = (Iteration / 20) % 3;
+		Rig.Manager->Tick(1.0f / 60.0f);
+	}
+	const double TotalTime = FPlatformTime::Seconds() - StartTime;
+
+	AddInfo(FString::Printf(
+		TEXT("Post-process update : %.3fus average over %d ticks"), TotalTime * 1000000.0 / IterationCount, IterationCount));
+
+	return true;
+}
+
+#endif
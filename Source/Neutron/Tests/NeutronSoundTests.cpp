@@ -0,0 +1,262 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronTests.h"
+#include "Neutron/System/NeutronSoundManager.h"
+#include "Neutron/Neutron.h"
+
+#include "Sound/SoundClass.h"
+#include "Sound/SoundMix.h"
+#include "Sound/SoundWave.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Stats
+DECLARE_CYCLE_STAT(TEXT("Sound update"), STAT_NeutronBenchmarkSound, STATGROUP_NeutronBenchmarks);
+
+/*----------------------------------------------------
+    Test setup
+----------------------------------------------------*/
+
+// Sound manager running headless with virtual music decks, with the mixer replaced by a recording sink
+struct FNeutronTestSoundRig
+{
+	FNeutronTestSoundRig() : SinkCallCount(0), SoundActive(false), MusicTrack(NAME_None)
+	{
+		Setup                    = NewObject<UNeutronSoundSetup>(GetTransientPackage());
+		Setup->MasterSoundMix    = NewObject<USoundMix>(GetTransientPackage());
+		Setup->MasterSoundClass  = NewObject<USoundClass>(GetTransientPackage());
+		Setup->UISoundClass      = NewObject<USoundClass>(GetTransientPackage());
+		Setup->EffectsSoundClass = NewObject<USoundClass>(GetTransientPackage());
+		Setup->MusicSoundClass   = NewObject<USoundClass>(GetTransientPackage());
+
+		FNeutronEnvironmentSoundEntry Entry;
+		Entry.Category = TEXT("Test");
+		Setup->Sounds.Add(TEXT("Test"), Entry);
+
+		// Music tracks stay in memory so that they don't need streaming
+		for (const TCHAR* TrackName : {TEXT("Calm"), TEXT("Combat")})
+		{
+			USoundWave* Wave = NewObject<USoundWave>(GetTransientPackage());
+			Wave->Duration   = 60.0f;
+
+			FNeutronMusicCatalogEntry& Track = Setup->Tracks.AddDefaulted_GetRef();
+			Track.Name                       = TrackName;
+			Track.Tracks.Add(Wave);
+		}
+
+		Manager = NewObject<UNeutronSoundManager>(GetTransientPackage());
+		Manager->BeginPlay(nullptr,
+			FNeutronMusicCallback::CreateLambda(
+				[this]()
+				{
+					return MusicTrack;
+				}),
+			Setup);
+		Manager->SetMixSink(FNeutronSoundMixSink::CreateLambda(
+			[this](USoundClass* SoundClass, float Volume, float FadeTime)
+			{
+				SinkVolumes.Add(SoundClass, Volume);
+				SinkCallCount++;
+			}));
+	}
+
+	~FNeutronTestSoundRig()
+	{
+		// The manager may still be ticked by the engine until it is collected
+		Manager->SetMixSink(FNeutronSoundMixSink());
+		Manager->BeginPlay(nullptr, FNeutronMusicCallback(), Setup);
+	}
+
+	UNeutronSoundSetup*       Setup;
+	UNeutronSoundManager*     Manager;
+	TMap<USoundClass*, float> SinkVolumes;
+	int32                     SinkCallCount;
+	bool                      SoundActive;
+	FName                     MusicTrack;
+};
+
+/*----------------------------------------------------
+    Tests
+----------------------------------------------------*/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronSoundMixTest, "Neutron.Sound.Mix",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNeutronSoundMixTest::RunTest(const FString& Parameters)
+{
+	FNeutronTestSoundRig Rig;
+	USoundClass*         MasterClass = Rig.Setup->MasterSoundClass;
+
+	// The initial volumes reach the mixer on the first tick
+	Rig.Manager->Tick(0.0f);
+	TestTrue(TEXT("Master volume is sent on the first tick"), Rig.SinkVolumes.Contains(MasterClass));
+	TestEqual(TEXT("Sent master volume matches the requested one"), Rig.SinkVolumes.FindRef(MasterClass),
+		Rig.Manager->GetMixVolume(MasterClass));
+
+	// Volume settings follow the 0-10 scale
+	for (int32 Volume = 0; Volume <= 10; Volume++)
+	{
+		Rig.Manager->SetMasterVolume(Volume);
+		Rig.Manager->Tick(0.0f);
+		TestEqual(FString::Printf(TEXT("Master volume %d is applied"), Volume), Rig.SinkVolumes.FindRef(MasterClass), Volume / 10.0f);
+	}
+
+	// Muting restores the volume set last
+	Rig.Manager->SetMasterVolume(7);
+	Rig.Manager->Mute();
+	Rig.Manager->Tick(0.0f);
+	TestEqual(TEXT("Mute silences the master class"), Rig.Manager->GetMixVolume(MasterClass), 0.0f);
+	Rig.Manager->UnMute();
+	Rig.Manager->Tick(0.0f);
+	TestEqual(TEXT("UnMute restores the master volume"), Rig.Manager->GetMixVolume(MasterClass), 0.7f);
+
+	// Several requests in a frame reach the mixer once, and unchanged volumes not at all
+	Rig.Manager->Tick(0.0f);
+	Rig.SinkCallCount = 0;
+	Rig.Manager->SetMasterVolume(2);
+	Rig.Manager->SetMasterVolume(4);
+	Rig.Manager->SetMusicVolume(FMath::RoundToInt(Rig.Manager->GetMixVolume(Rig.Setup->MusicSoundClass) * 10));
+	Rig.Manager->Tick(0.0f);
+	TestEqual(TEXT("Requests are coalesced per frame"), Rig.SinkCallCount, 1);
+	TestEqual(TEXT("Last request in a frame wins"), Rig.SinkVolumes.FindRef(MasterClass), 0.4f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronSoundEffectsTest, "Neutron.Sound.Effects",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNeutronSoundEffectsTest::RunTest(const FString& Parameters)
+{
+	FNeutronTestSoundRig Rig;
+	USoundClass*         EffectsClass = Rig.Setup->EffectsSoundClass;
+
+	// Effects run without menus when headless, so their volume follows the setting on the next tick
+	Rig.Setup->FadeEffectsInMenus = true;
+	for (int32 Volume = 10; Volume >= 0; Volume--)
+	{
+		Rig.Manager->SetEffectsVolume(Volume);
+		Rig.Manager->Tick(1.0f / 60.0f);
+		TestEqual(FString::Printf(TEXT("Effects volume %d is applied"), Volume), Rig.Manager->GetMixVolume(EffectsClass), Volume / 10.0f);
+	}
+
+	// Environment sounds stay virtual without a voice pool, and report the missing voice once audible
+	FNeutronSoundInstanceCallback Callback = FNeutronSoundInstanceCallback::CreateLambda(
+		[&Rig]()
+		{
+			return Rig.SoundActive;
+		});
+	Rig.Manager->AddEnvironmentSound(TEXT("Test"), Callback);
+
+	Rig.SoundActive = true;
+	for (int32 Step = 0; Step < 10; Step++)
+	{
+		Rig.Manager->Tick(1.0f / 60.0f);
+	}
+	TestTrue(TEXT("Audible headless sounds are counted as voice starvations"), Rig.Manager->GetStatistics().VoiceStarvations > 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronSoundMusicTest, "Neutron.Sound.Music",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNeutronSoundMusicTest::RunTest(const FString& Parameters)
+{
+	constexpr float DeltaTime = 0.05f;
+
+	FNeutronTestSoundRig Rig;
+	const float          FadeStep  = DeltaTime * Rig.Setup->MusicFadeSpeed;
+	const int32          FadeSteps = FMath::CeilToInt(1.0f / FadeStep);
+
+	// Requested tracks take a tick to be prefetched and another one to start, then fade in linearly
+	Rig.MusicTrack = TEXT("Calm");
+	Rig.Manager->Tick(DeltaTime);
+	Rig.Manager->Tick(DeltaTime);
+	TestEqual(TEXT("Requested track starts"), Rig.Manager->GetCurrentMusicTrack().ToString(), TEXT("Calm"));
+	for (int32 Step = 1; Step <= FadeSteps; Step++)
+	{
+		TestEqual(FString::Printf(TEXT("Fade in is linear at step %d"), Step), Rig.Manager->GetMusicDeckVolume(true),
+			FMath::Min(Step * FadeStep, 1.0f), 0.001f);
+		Rig.Manager->Tick(DeltaTime);
+	}
+	TestEqual(TEXT("Track fades in fully"), Rig.Manager->GetMusicDeckVolume(true), 1.0f);
+	TestEqual(TEXT("Previous deck fades out fully"), Rig.Manager->GetMusicDeckVolume(false), 0.0f);
+
+	// Switching tracks crossfades between decks at constant total volume
+	Rig.MusicTrack = TEXT("Combat");
+	Rig.Manager->Tick(DeltaTime);
+	Rig.Manager->Tick(DeltaTime);
+	TestEqual(TEXT("Switched track starts"), Rig.Manager->GetCurrentMusicTrack().ToString(), TEXT("Combat"));
+	for (int32 Step = 1; Step <= FadeSteps; Step++)
+	{
+		const float CurrentVolume  = Rig.Manager->GetMusicDeckVolume(true);
+		const float PreviousVolume = Rig.Manager->GetMusicDeckVolume(false);
+
+		TestEqual(FString::Printf(TEXT("Fade out is linear at step %d"), Step), PreviousVolume, FMath::Max(1.0f - Step * FadeStep, 0.0f),
+			0.001f);
+		TestEqual(FString::Printf(TEXT("Crossfade keeps the volume at step %d"), Step), CurrentVolume + PreviousVolume, 1.0f, 0.001f);
+		Rig.Manager->Tick(DeltaTime);
+	}
+
+	// Music stays on hold while the master volume is off
+	Rig.Manager->SetMasterVolume(0);
+	Rig.MusicTrack = TEXT("Calm");
+	for (int32 Step = 0; Step < 10; Step++)
+	{
+		Rig.Manager->Tick(DeltaTime);
+	}
+	TestEqual(TEXT("Muted music doesn't switch"), Rig.Manager->GetCurrentMusicTrack().ToString(), TEXT("Combat"));
+
+	Rig.Manager->SetMasterVolume(10);
+	Rig.Manager->Tick(DeltaTime);
+	Rig.Manager->Tick(DeltaTime);
+	TestEqual(TEXT("Music resumes with the volume"), Rig.Manager->GetCurrentMusicTrack().ToString(), TEXT("Calm"));
+	TestEqual(TEXT("Every switch is counted"), Rig.Manager->GetStatistics().MusicSwitches, 3);
+
+	return true;
+}
+
+/*----------------------------------------------------
+    Benchmarks
+----------------------------------------------------*/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNeutronSoundBenchmark, "Neutron.Benchmarks.Sound",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNeutronSoundBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 SoundCount     = 256;
+	constexpr int32 IterationCount = 10000;
+
+	FNeutronTestSoundRig Rig;
+	for (int32 Index = 0; Index < SoundCount; Index++)
+	{
+		FNeutronSoundInstanceCallback Callback = FNeutronSoundInstanceCallback::CreateLambda(
+			[Index, &Rig]()
+			{
+				return Rig.SoundActive && Index % 2 == 0;
+			});
+		Rig.Manager->AddEnvironmentSound(TEXT("Test"), Callback);
+	}
+
+	// Toggle the sounds and the volume so that every tick fades sounds and writes the mixer
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < IterationCount; Iteration++)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NeutronBenchmarkSound);
+
+		Rig.SoundActive = (Iteration / 60) % 2 == 0;
+		Rig.Manager->SetEffectsVolume(Iteration % 11);
+		Rig.Manager->Tick(1.0f / 60.0f);
+	}
+	const double TotalTime = FPlatformTime::Seconds() - StartTime;
+
+	AddInfo(FString::Printf(TEXT("Sound update : %.3fus average over %d ticks with %d sounds"), TotalTime * 1000000.0 / IterationCount,
+		IterationCount, SoundCount));
+
+	return true;
+}
+
+#endif
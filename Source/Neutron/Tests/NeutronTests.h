@@ -0,0 +1,9 @@
+// Neutron - Gwennaël Arbona
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// Stats shared by all benchmarks
+DECLARE_STATS_GROUP(TEXT("Neutron Benchmarks"), STATGROUP_NeutronBenchmarks, STATCAT_Advanced);
@@ -0,0 +1,132 @@
+// Neutron - Gwennaël Arbona
+
+#include "NeutronNotificationQueue.h"
+
+#include "Neutron/Neutron.h"
+
+/*----------------------------------------------------
+    Constructor
+----------------------------------------------------*/
+
+FNeutronNotificationQueue::FNeutronNotificationQueue()
+	: NotificationsPerSecond(2.0f), DisplayDuration(5.0f), MaxDisplayed(5), CurrentBudget(1.0f), Revision(0)
+{}
+
+/*----------------------------------------------------
+    Public methods
+----------------------------------------------------*/
+
+void FNeutronNotificationQueue::Configure(float NewNotificationsPerSecond, float NewDisplayDuration, int32 NewMaxDisplayed)
+{
+	NCHECK(NewNotificationsPerSecond > 0);
+	NCHECK(NewMaxDisplayed > 0);
+
+	NotificationsPerSecond = NewNotificationsPerSecond;
+	DisplayDuration        = NewDisplayDuration;
+	MaxDisplayed           = NewMaxDisplayed;
+}
+
+void FNeutronNotificationQueue::Push(const FText& Text, const FText& Subtext, ENeutronNotificationType Type)
+{
+	FNeutronNotification Notification(Text, Subtext, Type, GetDefaultPriority(Type));
+
+	// Collapse into a displayed notification and keep it on screen longer, without releasing it again
+	for (FNeutronNotification& Displayed : DisplayedNotifications)
+	{
+		if (Displayed.IsSameAs(Notification))
+		{
+			Displayed.Count++;
+			Displayed.Time = 0;
+			Revision++;
+			return;
+		}
+	}
+
+	// Collapse into a pending notification
+	for (FNeutronNotification& Pending : PendingNotifications)
+	{
+		if (Pending.IsSameAs(Notification))
+		{
+			Pending.Count++;
+			return;
+		}
+	}
+
+	// Insert after pending notifications of the same or higher priority
+	int32 InsertionIndex = PendingNotifications.IndexOfByPredicate(
+		[&](const FNeutronNotification& Pending)
+		{
+			return Pending.Priority < Notification.Priority;
+		});
+	PendingNotifications.Insert(Notification, InsertionIndex == INDEX_NONE ? PendingNotifications.Num() : InsertionIndex);
+}
+
+void FNeutronNotificationQueue::Tick(float DeltaTime)
+{
+	// Expire displayed notifications
+	int32 PreviousDisplayedCount = DisplayedNotifications.Num();
+	for (FNeutronNotification& Displayed : DisplayedNotifications)
+	{
+		Displayed.Time += DeltaTime;
+	}
+	DisplayedNotifications.RemoveAll(
+		[&](const FNeutronNotification& Displayed)
+		{
+			return Displayed.Time > DisplayDuration;
+		});
+	if (DisplayedNotifications.Num() != PreviousDisplayedCount)
+	{
+		Revision++;
+	}
+
+	// Refill the budget, allowing at most one second of burst
+	CurrentBudget = FMath::Min(CurrentBudget + DeltaTime * NotificationsPerSecond, FMath::Max(NotificationsPerSecond, 1.0f));
+
+	// Release pending notifications by priority
+	while (PendingNotifications.Num() && CurrentBudget >= 1.0f && DisplayedNotifications.Num() < MaxDisplayed)
+	{
+		FNeutronNotification Notification = PendingNotifications[0];
+		PendingNotifications.RemoveAt(0);
+
+		int32 InsertionIndex = DisplayedNotifications.IndexOfByPredicate(
+			[&](const FNeutronNotification& Displayed)
+			{
+				return Displayed.Priority < Notification.Priority;
+			});
+		DisplayedNotifications.Insert(Notification, InsertionIndex == INDEX_NONE ? DisplayedNotifications.Num() : InsertionIndex);
+
+		CurrentBudget -= 1.0f;
+		Revision++;
+		NewNotifications.Add(Notification);
+	}
+}
+
+void FNeutronNotificationQueue::Clear()
+{
+	PendingNotifications.Empty();
+	DisplayedNotifications.Empty();
+	NewNotifications.Empty();
+	Revision++;
+}
+
+void FNeutronNotificationQueue::ConsumeNewNotifications(TArray<FNeutronNotification>& Notifications)
+{
+	Notifications = MoveTemp(NewNotifications);
+	NewNotifications.Reset();
+}
+
+int32 FNeutronNotificationQueue::GetDefaultPriority(ENeutronNotificationType Type)
+{
+	switch (Type)
+	{
+		case ENeutronNotificationType::Error:
+			return 3;
+		case ENeutronNotificationType::Save:
+			return 2;
+		case ENeutronNotificationType::World:
+		case ENeutronNotificationType::Time:
+			return 1;
+		default:
+			return 0;
+	}
+}
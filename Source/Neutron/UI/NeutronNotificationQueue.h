@@ -0,0 +1,100 @@
+// Neutron - Gwennaël Arbona
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NeutronUI.h"
+
+/*----------------------------------------------------
+    Supporting types
+----------------------------------------------------*/
+
+/** Notification entry */
+struct FNeutronNotification
+{
+	FNeutronNotification() : Type(ENeutronNotificationType::Info), Priority(0), Count(1), Time(0)
+	{}
+
+	FNeutronNotification(const FText& T, const FText& S, ENeutronNotificationType NewType, int32 NewPriority)
+		: Text(T), Subtext(S), Type(NewType), Priority(NewPriority), Count(1), Time(0)
+	{}
+
+	/** Check if two notifications should be collapsed into one */
+	bool IsSameAs(const FNeutronNotification& Other) const
+	{
+		return Type == Other.Type && Text.EqualTo(Other.Text) && Subtext.EqualTo(Other.Subtext);
+	}
+
+	FText                    Text;
+	FText                    Subtext;
+	ENeutronNotificationType Type;
+	int32                    Priority;
+	int32                    Count;
+	float                    Time;
+};
+
+/*----------------------------------------------------
+    Notification queue
+----------------------------------------------------*/
+
+/** Notification queue with de-duplication, priorities and a display budget */
+class NEUTRON_API FNeutronNotificationQueue
+{
+public:
+
+	FNeutronNotificationQueue();
+
+	/** Set how many notifications can be shown per second, for how long, and how many at once */
+	void Configure(float NewNotificationsPerSecond, float NewDisplayDuration, int32 NewMaxDisplayed);
+
+	/** Add a notification, collapsing it into an identical one if already queued or displayed */
+	void Push(const FText& Text, const FText& Subtext, ENeutronNotificationType Type);
+
+	/** Release pending notifications within the display budget, expire old ones */
+	void Tick(float DeltaTime);
+
+	/** Remove all notifications */
+	void Clear();
+
+	/** Move the notifications released since the last call into an array, updates to displayed ones only change the revision */
+	void ConsumeNewNotifications(TArray<FNeutronNotification>& Notifications);
+
+	/** Get the notifications to display, most important first */
+	const TArray<FNeutronNotification>& GetDisplayedNotifications() const
+	{
+		return DisplayedNotifications;
+	}
+
+	/** Get a counter that changes every time the displayed list does */
+	uint32 GetRevision() const
+	{
+		return Revision;
+	}
+
+	/** Get the number of notifications waiting for display */
+	int32 GetPendingCount() const
+	{
+		return PendingNotifications.Num();
+	}
+
+	/** Get the default priority of a notification type */
+	static int32 GetDefaultPriority(ENeutronNotificationType Type);
+
+protected:
+
+	/*----------------------------------------------------
+	    Data
+	----------------------------------------------------*/
+
+	// Settings
+	float NotificationsPerSecond;
+	float DisplayDuration;
+	int32 MaxDisplayed;
+
+	// State
+	float                        CurrentBudget;
+	uint32                       Revision;
+	TArray<FNeutronNotification> PendingNotifications;
+	TArray<FNeutronNotification> DisplayedNotifications;
+	TArray<FNeutronNotification> NewNotifications;
+};
@@ -2,6 +2,13 @@
 
 #include "NeutronUI.h"
 
+/*----------------------------------------------------
+    Game menu dependencies
+----------------------------------------------------*/
+
+const FName FNeutronGameMenuDependencies::Contracts = "Contracts";
+const FName FNeutronGameMenuDependencies::Sessions  = "Sessions";
+
 /*----------------------------------------------------
     Player input bindings
 ----------------------------------------------------*/
@@ -79,7 +79,35 @@ class INeutronGameMenu
 {
 public:
 
+	/** Refresh the game objects displayed by this menu */
 	virtual void UpdateGameObjects(){};
+
+	/** Get a name for this menu in statistics */
+	virtual FName GetGameMenuName() const
+	{
+		return TEXT("GameMenu");
+	}
+
+	/** Check if this menu is displayed beyond its widget state, hidden menus are only updated when their dependencies change */
+	virtual bool IsGameMenuVisible() const
+	{
+		return true;
+	}
+
+	/** Get the minimum time in seconds between updates of a visible menu, 0 to update every frame */
+	virtual float GetGameMenuUpdatePeriod() const
+	{
+		return 0.0f;
+	}
+};
+
+/** Game data signalled to game menus when it changes */
+class NEUTRON_API FNeutronGameMenuDependencies
+{
+public:
+
+	static const FName Contracts;
+	static const FName Sessions;
 };
 
 /*----------------------------------------------------